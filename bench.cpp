@@ -0,0 +1,150 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <cstdint>
+#include <sstream>
+#include "spsc_queue.h"
+#include "inclang.h"
+
+// --- Queue Microbenchmarks ---
+// Moves 'items' integers from a producer thread to a consumer thread and reports the throughput of
+// the lock-free SpscQueue (single and batched operations) against a mutex+condvar bounded queue.
+const std::size_t queue_capacity=1024,batch_size=64;
+
+// Baseline: the usual blocking bounded queue guarded by one mutex and two condition variables.
+template<typename T>class MutexQueue{
+private:
+    std::deque<T> items;std::size_t capacity;std::mutex lock;std::condition_variable not_full,not_empty;
+public:
+    explicit MutexQueue(std::size_t cap):capacity(cap){}
+    void push(T item){std::unique_lock<std::mutex> guard(lock);not_full.wait(guard,[&]{return items.size()<capacity;});items.push_back(std::move(item));guard.unlock();not_empty.notify_one();}
+    T pop(){std::unique_lock<std::mutex> guard(lock);not_empty.wait(guard,[&]{return !items.empty();});T item=std::move(items.front());items.pop_front();guard.unlock();not_full.notify_one();return item;}
+};
+
+template<typename Producer,typename Consumer>double measure(Producer produce,Consumer consume){
+    auto start=std::chrono::steady_clock::now();std::thread producer(produce);consume();producer.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+}
+std::uint64_t benchSpsc(std::uint64_t items,double& seconds){
+    SpscQueue<std::uint64_t> queue(queue_capacity);std::uint64_t sum=0;
+    seconds=measure([&]{for(std::uint64_t i=0;i<items;i++){while(!queue.tryPush(i))std::this_thread::yield();}},
+                    [&]{std::uint64_t v;for(std::uint64_t i=0;i<items;i++){while(!queue.tryPop(v))std::this_thread::yield();sum+=v;}});
+    return sum;
+}
+std::uint64_t benchSpscBatch(std::uint64_t items,double& seconds){
+    SpscQueue<std::uint64_t> queue(queue_capacity);std::uint64_t sum=0;
+    seconds=measure([&]{std::uint64_t buf[batch_size];for(std::uint64_t i=0;i<items;){std::size_t n=0;while(n<batch_size&&i+n<items){buf[n]=i+n;n++;}std::size_t sent=0;while(sent<n){std::size_t k=queue.tryPushBatch(buf+sent,n-sent);if(!k)std::this_thread::yield();sent+=k;}i+=n;}},
+                    [&]{std::uint64_t buf[batch_size];for(std::uint64_t got=0;got<items;){std::size_t k=queue.tryPopBatch(buf,batch_size);if(!k){std::this_thread::yield();continue;}for(std::size_t j=0;j<k;j++)sum+=buf[j];got+=k;}});
+    return sum;
+}
+std::uint64_t benchMutex(std::uint64_t items,double& seconds){
+    MutexQueue<std::uint64_t> queue(queue_capacity);std::uint64_t sum=0;
+    seconds=measure([&]{for(std::uint64_t i=0;i<items;i++)queue.push(i);},[&]{for(std::uint64_t i=0;i<items;i++)sum+=queue.pop();});
+    return sum;
+}
+void report(const std::string& name,std::uint64_t items,std::uint64_t sum,double seconds){
+    std::uint64_t expected=items*(items-1)/2;
+    std::cout<<std::left<<std::setw(24)<<name<<std::right<<std::setw(10)<<std::fixed<<std::setprecision(1)<<(items/seconds/1e6)<<" Mops/s"<<(sum==expected?"":"  (CHECKSUM MISMATCH)")<<"\n";
+}
+
+// --- Backend Benchmarks ---
+// Runs one generated program on the AST Interpreter and on the register Vm and reports the dispatches
+// each needs (AST nodes visited against instructions executed) and the statements run per second. The
+// program declares 'variables' variables and then prints inc chains of depth 1-3 over them, reassigning
+// one variable in every fourth statement. Output goes to a buffer that only hashes it, so both backends
+// pay the same formatting cost and their outputs are checked against each other.
+class HashBuffer:public std::streambuf{
+private:
+    char buffer[8192];
+    void consume(){for(char* p=pbase();p<pptr();p++){hash^=static_cast<unsigned char>(*p);hash*=1099511628211ULL;}setp(buffer,buffer+sizeof(buffer));}
+protected:
+    int overflow(int c)override{consume();if(!traits_type::eq_int_type(c,traits_type::eof())){*pptr()=traits_type::to_char_type(c);pbump(1);}return traits_type::not_eof(c);}
+    int sync()override{consume();return 0;}
+public:
+    std::uint64_t hash=14695981039346656037ULL;
+    HashBuffer(){setp(buffer,buffer+sizeof(buffer));}
+};
+std::string generateProgram(std::size_t statements,std::size_t variables){
+    std::ostringstream src;
+    for(std::size_t v=0;v<variables;v++)src<<"v"<<v<<"="<<v<<";\n";
+    for(std::size_t i=0;i<statements;i++){
+        std::string var="v"+std::to_string(i*7%variables);
+        if(i%4==3){src<<var<<"="<<i<<";\n";continue;}
+        std::size_t depth=i%3+1;src<<"print(";for(std::size_t d=0;d<depth;d++)src<<"inc(";src<<var<<std::string(depth,')')<<");\n";
+    }
+    return src.str();
+}
+std::uint64_t astDispatches(const Program& program){
+    std::uint64_t count=0;
+    for(const auto& stmt:program.statements){
+        count++;const PrintStmt* print=dynamic_cast<const PrintStmt*>(stmt.get());
+        for(const Expr* expr=print?print->expression.get():nullptr;expr;){count++;const IncCallExpr* inc=dynamic_cast<const IncCallExpr*>(expr);expr=inc?inc->argument.get():nullptr;}
+    }
+    return count;
+}
+void benchBackends(std::size_t statements,int runs){
+    std::string source=generateProgram(statements,64);Diagnostics diagnostics;
+    Lexer lexer(source);Parser parser(lexer,diagnostics);std::unique_ptr<Program> ast=parser.parse();
+    SemanticAnalyzer analyzer(diagnostics,false);analyzer.analyze(ast.get());Bytecode bytecode;bytecode.compile(*ast,analyzer.slotCount(),IntMode());
+    if(diagnostics.hasErrors()){diagnostics.print(std::cerr,lexer.lineIndex());return;}
+    std::size_t total=ast->statements.size();HashBuffer ast_out,vm_out;std::ostream ast_stream(&ast_out),vm_stream(&vm_out);
+    Interpreter interpreter(diagnostics,ast_stream,false);Vm vm(diagnostics,vm_stream);double ast_best=1e9,vm_best=1e9;
+    for(int r=0;r<runs;r++){
+        auto start=std::chrono::steady_clock::now();interpreter.reset(analyzer.slotCount());interpreter.interpret(ast.get());ast_stream.flush();
+        ast_best=std::min(ast_best,std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+        start=std::chrono::steady_clock::now();vm.run(bytecode);vm_stream.flush();
+        vm_best=std::min(vm_best,std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+    }
+    std::cout<<"\nRunning "<<total<<" statements, best of "<<runs<<"\n";
+    std::cout<<std::left<<std::setw(24)<<"AST Interpreter"<<std::right<<std::setw(10)<<astDispatches(*ast)<<" dispatches"<<std::setw(10)<<std::fixed<<std::setprecision(1)<<(total/ast_best/1e6)<<" Mstmt/s\n";
+    std::cout<<std::left<<std::setw(24)<<"Register VM"<<std::right<<std::setw(10)<<bytecode.code.size()<<" dispatches"<<std::setw(10)<<std::fixed<<std::setprecision(1)<<(total/vm_best/1e6)<<" Mstmt/s"<<(ast_out.hash==vm_out.hash?"":"  (OUTPUT MISMATCH)")<<"\n";
+    // The same program on the interpreter over one pool worker per hardware thread.
+    WorkStealingPool pool(std::max(2u,std::thread::hardware_concurrency()));HashBuffer parallel_out;std::ostream parallel_stream(&parallel_out);
+    Interpreter parallel(diagnostics,parallel_stream,false);double parallel_best=1e9;
+    for(int r=0;r<runs;r++){
+        auto start=std::chrono::steady_clock::now();parallel.reset(analyzer.slotCount());parallel.interpretParallel(ast.get(),pool);parallel_stream.flush();
+        parallel_best=std::min(parallel_best,std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+    }
+    std::cout<<std::left<<std::setw(24)<<"Parallel Interpreter"<<std::right<<std::setw(10)<<pool.size()<<" workers   "<<std::setw(10)<<std::fixed<<std::setprecision(1)<<(total/parallel_best/1e6)<<" Mstmt/s"<<(ast_out.hash==parallel_out.hash?"":"  (OUTPUT MISMATCH)")<<"\n";
+    // A tiered Engine runs the same program repeatedly: interpreted until it turns hot, native after.
+    Engine engine(IntMode(),Backend::Tiered);std::shared_ptr<const CompiledProgram> program=engine.compile(source);HashBuffer tiered_out;
+    std::cout<<"Tiered Engine, per run:";
+    for(int r=0;r<runs;r++){
+        auto start=std::chrono::steady_clock::now();engine.run(*program,[&](const char* data,std::size_t size){tiered_out.sputn(data,static_cast<std::streamsize>(size));});
+        std::cout<<" "<<std::setprecision(1)<<std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-start).count()<<" ms";
+    }
+    tiered_out.pubsync();std::cout<<(ast_out.hash==tiered_out.hash?"":"  (OUTPUT MISMATCH)")<<"\n";
+}
+
+// --- Array Kernel Benchmarks ---
+// Times inc_elements() with a chain of 3 incs over an array too large for the caches, on every
+// instruction set the CPU has, and reports the bytes read and written per second.
+void benchArrayKernels(std::size_t elements,int runs){
+    std::vector<std::int64_t> in(elements),out(elements);for(std::size_t i=0;i<elements;i++)in[i]=static_cast<std::int64_t>(i%1000);
+    std::cout<<"\nArray inc over "<<elements<<" elements, best of "<<runs<<"\n";
+    for(int isa=0;isa<=static_cast<int>(best_isa());isa++){
+        double best=1e9;std::size_t failed=0;
+        for(int r=0;r<runs;r++){
+            auto start=std::chrono::steady_clock::now();failed=inc_elements(in.data(),out.data(),elements,3,IntMode(),static_cast<Isa>(isa));
+            best=std::min(best,std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+        }
+        bool correct=failed==elements&&out[elements-1]==in[elements-1]+3;
+        std::cout<<std::left<<std::setw(24)<<isa_name(static_cast<Isa>(isa))<<std::right<<std::setw(10)<<std::fixed<<std::setprecision(1)<<(elements*2*sizeof(std::int64_t)/best/1e9)<<" GB/s"<<(correct?"":"  (RESULT MISMATCH)")<<"\n";
+    }
+}
+
+int main(int argc,char** argv){
+    std::uint64_t items=argc>1?std::stoull(argv[1]):20000000ULL;double seconds=0;
+    std::cout<<"Transferring "<<items<<" items, capacity "<<queue_capacity<<", "<<std::thread::hardware_concurrency()<<" hardware threads\n";
+    std::uint64_t sum=benchSpsc(items,seconds);report("SpscQueue",items,sum,seconds);
+    sum=benchSpscBatch(items,seconds);report("SpscQueue (batch 64)",items,sum,seconds);
+    sum=benchMutex(items,seconds);report("mutex+condvar queue",items,sum,seconds);
+    benchBackends(argc>2?std::stoull(argv[2]):1000000,5);
+    benchArrayKernels(std::size_t(1)<<23,5);
+    return 0;
+}
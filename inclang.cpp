@@ -0,0 +1,1171 @@
+#include "inclang.h"
+#include <algorithm>
+#include <cstring>
+#include <csignal>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <unordered_map>
+#include <unordered_set>
+#include <type_traits>
+#include <charconv>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__x86_64__)&&(defined(__GNUC__)||defined(__clang__))
+#define INCLANG_X86_KERNELS
+#include <immintrin.h>
+#endif
+#if defined(__x86_64__)&&defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#if defined(__unix__)
+#include <sys/time.h>
+#endif
+
+// --- Source Locations ---
+void LineIndex::scan(const char* data,std::size_t size,std::size_t base){
+    std::size_t i=0;
+#if defined(__SSE2__)
+    const __m128i newline=_mm_set1_epi8('\n');
+    for(;i+16<=size;i+=16){
+        unsigned mask=static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data+i)),newline)));
+        while(mask){addLine(base+i+static_cast<std::size_t>(__builtin_ctz(mask))+1);mask&=mask-1;}
+    }
+#endif
+    for(;i<size;i++){if(data[i]=='\n')addLine(base+i+1);}
+}
+SourceLocation LineIndex::locate(std::uint32_t offset)const{
+    std::size_t line=static_cast<std::size_t>(std::upper_bound(line_starts.begin(),line_starts.end(),offset)-line_starts.begin());
+    if(!line)return{first_line,1};
+    return{first_line-1+static_cast<std::uint32_t>(line),offset-line_starts[line-1]+1};
+}
+void LineIndex::discard(std::uint32_t offset){
+    std::size_t line=static_cast<std::size_t>(std::upper_bound(line_starts.begin(),line_starts.end(),offset)-line_starts.begin());
+    if(line<2)return;
+    line_starts.erase(line_starts.begin(),line_starts.begin()+static_cast<std::ptrdiff_t>(line-1));first_line+=static_cast<std::uint32_t>(line-1);
+}
+std::uint32_t LineIndex::offsetOf(SourceLocation loc,std::uint32_t source_size)const{
+    if(loc.line<1)return 0;
+    if(loc.line>line_starts.size())return source_size;
+    std::uint32_t start=line_starts[loc.line-1],end=loc.line<line_starts.size()?line_starts[loc.line]-1:source_size;
+    return std::min(start+(loc.column?loc.column-1:0),end);
+}
+// Line starts inside the removed range disappear, later ones move by the size difference, and the
+// inserted text's newlines are spliced in between.
+void LineIndex::edit(std::uint32_t offset,std::uint32_t removed,std::string_view inserted){
+    auto first=std::upper_bound(line_starts.begin(),line_starts.end(),offset),last=std::upper_bound(first,line_starts.end(),offset+removed);
+    std::uint32_t grown=static_cast<std::uint32_t>(inserted.size()),shrunk=removed;
+    for(auto it=last;it!=line_starts.end();++it)*it=*it-shrunk+grown;
+    std::vector<std::uint32_t> added;for(std::size_t i=0;i<inserted.size();i++){if(inserted[i]=='\n')added.push_back(offset+static_cast<std::uint32_t>(i)+1);}
+    line_starts.insert(line_starts.erase(first,last),added.begin(),added.end());
+}
+
+// --- Diagnostics ---
+void Diagnostics::print(std::ostream& os,const LineIndex& lines,const std::string& prefix)const{
+    static const char* const phase_names[]={"Syntax Error","Semantic Error","Runtime Error"};
+    for(const Diagnostic& d:entries){
+        os<<prefix<<phase_names[static_cast<int>(d.phase)]<<": "<<d.message;
+        if(d.offset!=no_location){SourceLocation loc=d.location.line?d.location:lines.locate(d.offset);os<<" at line "<<loc.line<<", column "<<loc.column;}
+        os<<"\n";
+    }
+    if(dropped)os<<prefix<<"... "<<dropped<<" more error(s) not shown\n";
+}
+
+// --- Memory Accounting ---
+static thread_local MemoryBudget* active_budget=nullptr;
+void MemoryBudget::Counter::add(std::size_t bytes){
+    std::size_t now=current.fetch_add(bytes,std::memory_order_relaxed)+bytes,seen=peak.load(std::memory_order_relaxed);
+    while(now>seen&&!peak.compare_exchange_weak(seen,now,std::memory_order_relaxed)){}
+}
+void MemoryBudget::restart(){
+    for(Counter* counter:{&phases[0],&phases[1],&phases[2],&total})counter->peak.store(counter->current.load(std::memory_order_relaxed),std::memory_order_relaxed);
+    over.store(total.current.load(std::memory_order_relaxed)>limit,std::memory_order_relaxed);reported.store(false);
+}
+void MemoryBudget::print(std::ostream& os)const{os<<"Peak memory: "<<peakTotal()<<" bytes (syntax "<<peak(Phase::Syntax)<<", semantic "<<peak(Phase::Semantic)<<", runtime "<<peak(Phase::Runtime)<<")\n";}
+MemoryBudget* MemoryBudget::active(){return active_budget;}
+bool MemoryBudget::exhausted(Diagnostics& diagnostics,Phase phase){
+    MemoryBudget* budget=active_budget;if(!budget||!budget->over.load(std::memory_order_relaxed))return false;
+    if(!budget->reported.exchange(true))diagnostics.report(phase,no_location,0,"Memory limit of "+std::to_string(budget->limit)+" bytes exceeded");
+    return true;
+}
+MemoryScope::MemoryScope(MemoryBudget& budget):previous(active_budget){active_budget=&budget;}
+MemoryScope::MemoryScope(MemoryBudget* budget):previous(active_budget){active_budget=budget;}
+MemoryScope::~MemoryScope(){active_budget=previous;}
+// Every node type needs at most 8-byte alignment, so an 8-byte header keeps nodes aligned.
+constexpr std::size_t node_header=8;
+static_assert(alignof(VarDeclStmt)<=node_header&&alignof(PrintStmt)<=node_header&&alignof(RepeatStmt)<=node_header&&alignof(ElementAssignStmt)<=node_header&&alignof(IndexExpr)<=node_header&&alignof(IncCallExpr)<=node_header&&alignof(IdentifierExpr)<=node_header&&alignof(NumberExpr)<=node_header&&alignof(Program)<=node_header,"AST node alignment exceeds its header");
+void* ASTNode::operator new(std::size_t size){
+    MemoryBudget* budget=active_budget;char* block=static_cast<char*>(::operator new(size+node_header));
+    std::memcpy(block,&budget,sizeof(budget));if(budget)budget->charge(Phase::Syntax,size+node_header);
+    return block+node_header;
+}
+void ASTNode::operator delete(void* node,std::size_t size){
+    char* block=static_cast<char*>(node)-node_header;MemoryBudget* budget;std::memcpy(&budget,block,sizeof(budget));
+    if(budget)budget->refund(Phase::Syntax,size+node_header);
+    ::operator delete(block);
+}
+
+// --- Work-Stealing Thread Pool ---
+bool WorkStealingPool::takeOwn(std::size_t worker,std::size_t& task){TaskQueue& q=*queues[worker];std::lock_guard<std::mutex> guard(q.lock);if(q.tasks.empty())return false;task=q.tasks.front();q.tasks.pop_front();return true;}
+bool WorkStealingPool::steal(std::size_t worker,std::size_t& task){
+    for(std::size_t i=1;i<queues.size();i++){TaskQueue& q=*queues[(worker+i)%queues.size()];std::lock_guard<std::mutex> guard(q.lock);if(!q.tasks.empty()){task=q.tasks.back();q.tasks.pop_back();return true;}}
+    return false;
+}
+void WorkStealingPool::workerLoop(std::size_t worker){
+    for(std::size_t seen=0;;){
+        {std::unique_lock<std::mutex> guard(state_lock);wake.wait(guard,[&]{return stopping||generation!=seen;});if(stopping)return;seen=generation;}
+        std::size_t task;while(takeOwn(worker,task)||steal(worker,task)){(*job)(task,worker);}
+        {std::lock_guard<std::mutex> guard(state_lock);if(--busy==0)finished.notify_all();}
+    }
+}
+WorkStealingPool::WorkStealingPool(std::size_t workers){
+    if(workers==0)workers=1;
+    for(std::size_t i=0;i<workers;i++)queues.push_back(std::make_unique<TaskQueue>());
+    for(std::size_t i=0;i<workers;i++)threads.emplace_back([this,i]{workerLoop(i);});
+}
+WorkStealingPool::~WorkStealingPool(){{std::lock_guard<std::mutex> guard(state_lock);stopping=true;}wake.notify_all();for(std::thread& t:threads)t.join();}
+void WorkStealingPool::run(std::size_t count,const std::function<void(std::size_t,std::size_t)>& fn){
+    std::size_t per=(count+queues.size()-1)/queues.size();
+    for(std::size_t w=0;w<queues.size();w++){std::lock_guard<std::mutex> guard(queues[w]->lock);for(std::size_t t=w*per;t<count&&t<(w+1)*per;t++)queues[w]->tasks.push_back(t);}
+    std::unique_lock<std::mutex> guard(state_lock);job=&fn;busy=threads.size();generation++;wake.notify_all();
+    finished.wait(guard,[&]{return busy==0;});job=nullptr;
+}
+
+// --- Lexer (Scanner) ---
+// In streaming mode 'window' holds only part of the input: consumed bytes are dropped on each refill,
+// so memory stays bounded by the chunk size plus the longest token. Each chunk is scanned for line
+// starts before it can be dropped; the starts themselves are kept until discardLines(). Input past
+// max_source_size is not read: the stream ends there and reportTruncation() records the error.
+bool Lexer::refill(){
+    if(!input||!*input||truncated)return false;
+    base_offset+=current_pos;window.erase(0,current_pos);current_pos=0;
+    char chunk[4096];input->read(chunk,sizeof(chunk));std::size_t n=static_cast<std::size_t>(input->gcount());
+    std::size_t room=max_source_size-(base_offset+window.size());if(n>room){n=room;truncated=true;}
+    lines.scan(chunk,n,base_offset+window.size());window.append(chunk,n);source=window;return n>0;
+}
+void Lexer::reportTruncation(Diagnostics& diagnostics)const{if(truncated)diagnostics.report(Phase::Syntax,no_location,0,"Input exceeds the 4 GiB source limit; stopped reading at byte "+std::to_string(max_source_size));}
+Token Lexer::scanIdentifier(std::uint32_t start){std::string lexeme;while(std::isalpha(peek())||std::isdigit(peek())||peek()=='_'){lexeme+=advance();}if(keywords.count(lexeme)){return{keywords[lexeme],lexeme,start};}return{TokenType::IDENTIFIER,lexeme,start};}
+// Converts the eight ASCII digits at 'p' with a handful of 64-bit multiplies (SWAR), or returns false if
+// any of them is not a digit. Big-endian targets always take the digit-by-digit path.
+static bool eightDigits(const char* p,std::uint64_t& value){
+#if (defined(__BYTE_ORDER__)&&__BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__)||defined(_WIN32)
+    std::uint64_t x;std::memcpy(&x,p,8);
+    if((((x&0xF0F0F0F0F0F0F0F0ULL)|(((x+0x0606060606060606ULL)&0xF0F0F0F0F0F0F0F0ULL)>>4)))!=0x3333333333333333ULL)return false;
+    x-=0x3030303030303030ULL;x=x*10+(x>>8); // adjacent digits -> two-digit numbers in every other byte
+    value=(((x&0x000000FF000000FFULL)*(100+(1000000ULL<<32)))+(((x>>16)&0x000000FF000000FFULL)*(1+(10000ULL<<32))))>>32;
+    return true;
+#else
+    (void)p;(void)value;return false;
+#endif
+}
+// The value is accumulated while scanning, eight digits at a time whenever eight more bytes are buffered.
+Token Lexer::scanNumber(std::uint32_t start){
+    Token t{TokenType::NUMBER,"",start};
+    auto accumulate=[&t](std::uint64_t scale,std::uint64_t digits){if(__builtin_mul_overflow(t.value,scale,&t.value)||__builtin_add_overflow(t.value,digits,&t.value))t.overflowed=true;};
+    for(std::uint64_t chunk;;){
+        if(source.size()-current_pos>=8&&eightDigits(source.data()+current_pos,chunk)){accumulate(100000000,chunk);t.lexeme.append(source.data()+current_pos,8);current_pos+=8;continue;}
+        char c=peek();if(!std::isdigit(static_cast<unsigned char>(c)))break;
+        accumulate(10,static_cast<std::uint64_t>(c-'0'));t.lexeme+=c;current_pos++;
+    }
+    return t;
+}
+Token Lexer::nextToken(){
+    skipWhitespace();if(atEnd()){return{TokenType::END_OF_FILE,"",offset()};}std::uint32_t start=offset();char c=advance();
+    if(std::isalpha(c)){current_pos--;return scanIdentifier(start);}if(std::isdigit(c)){current_pos--;return scanNumber(start);}
+    switch(c){case'=':return{TokenType::ASSIGN,"=",start};case';':return{TokenType::SEMICOLON,";",start};case'(':return{TokenType::LPAREN,"(",start};case')':return{TokenType::RPAREN,")",start};case'{':return{TokenType::LBRACE,"{",start};case'}':return{TokenType::RBRACE,"}",start};case'[':return{TokenType::LBRACKET,"[",start};case']':return{TokenType::RBRACKET,"]",start};default:return{TokenType::UNKNOWN,std::string(1,c),start};}
+}
+
+// --- Parser (Syntax Analysis) ---
+void Parser::error(const std::string& msg){if(!panicking){diagnostics.report(Phase::Syntax,current_token.offset,static_cast<std::uint32_t>(current_token.lexeme.size()),msg+(check(TokenType::END_OF_FILE)?" (Found end of input)":" (Found '"+current_token.lexeme+"')"));}panicking=true;}
+// Once a statement has failed nothing more is consumed, so synchronize() starts from the error.
+Token Parser::consume(TokenType expected_type,const std::string& msg){if(!panicking&&check(expected_type)){Token t=current_token;advance();return t;}error(msg);return{expected_type,"",current_token.offset};}
+// Whether the literal fits the mode's range. In Big mode one that does not is no error: number() keeps its
+// digits (without leading zeros) instead. Otherwise the error does not abandon the statement, which is
+// often already complete, so recovery cannot swallow the next one; the literal reads as 0.
+bool Parser::inRange(const Token& t){
+    if(!t.overflowed&&t.value<=static_cast<std::uint64_t>(mode.max()))return true;
+    if(mode.width!=IntWidth::Big){diagnostics.report(Phase::Syntax,t.offset,static_cast<std::uint32_t>(t.lexeme.size()),"Integer literal '"+t.lexeme+"' is out of range");}
+    return false;
+}
+std::unique_ptr<NumberExpr> Parser::number(const Token& t){
+    auto node=at(std::make_unique<NumberExpr>(0),t.offset);if(panicking)return node;
+    if(inRange(t)){node->value=static_cast<std::int64_t>(t.value);}
+    else if(mode.width==IntWidth::Big){node->digits=t.lexeme.substr(t.lexeme.find_first_not_of('0'));}
+    return node;
+}
+std::unique_ptr<IncCallExpr> Parser::parseIncCall(){Token kw=consume(TokenType::INC,"Expected 'inc'");consume(TokenType::LPAREN,"Expected '('");std::unique_ptr<Expr> arg=parseExpr();consume(TokenType::RPAREN,"Expected ')'");return at(std::make_unique<IncCallExpr>(std::move(arg)),kw.offset);}
+std::unique_ptr<Expr> Parser::parseExpr(){
+    if(panicking)return nullptr; // a failed 'inc(' must not recurse on the token it could not consume
+    if(check(TokenType::NUMBER)){Token t=consume(TokenType::NUMBER,"Expected number");return number(t);}
+    if(check(TokenType::IDENTIFIER)){Token t=consume(TokenType::IDENTIFIER,"Expected identifier");if(check(TokenType::LBRACKET))return parseIndex(t);return at(std::make_unique<IdentifierExpr>(t.lexeme),t.offset);}
+    if(check(TokenType::INC)){return parseIncCall();}
+    error("Expected expression");return nullptr;
+}
+// An index too large for 64 bits is kept as UINT64_MAX, which no array reaches.
+std::unique_ptr<IndexExpr> Parser::parseIndex(const Token& name){
+    consume(TokenType::LBRACKET,"Expected '['");Token index=consume(TokenType::NUMBER,"Expected index");consume(TokenType::RBRACKET,"Expected ']'");
+    return at(std::make_unique<IndexExpr>(at(std::make_unique<IdentifierExpr>(name.lexeme),name.offset),index.overflowed?UINT64_MAX:index.value),name.offset);
+}
+std::unique_ptr<Stmt> Parser::parseAssignment(){
+    Token name=consume(TokenType::IDENTIFIER,"Expected name");
+    if(check(TokenType::LBRACKET)){
+        std::unique_ptr<IndexExpr> target=parseIndex(name);consume(TokenType::ASSIGN,"Expected '='");Token val=consume(TokenType::NUMBER,"Expected value");consume(TokenType::SEMICOLON,"Expected ';'");
+        return at(std::make_unique<ElementAssignStmt>(std::move(target),number(val)),name.offset);
+    }
+    consume(TokenType::ASSIGN,"Expected '='");bool array=!panicking&&check(TokenType::LBRACKET);if(array){advance();arrays=true;}
+    Token val=consume(TokenType::NUMBER,array?"Expected array length":"Expected value");if(array)consume(TokenType::RBRACKET,"Expected ']'");consume(TokenType::SEMICOLON,"Expected ';'");
+    auto decl=at(std::make_unique<VarDeclStmt>(name.lexeme,number(val)),name.offset);decl->array=array;return decl;
+}
+std::unique_ptr<PrintStmt> Parser::parsePrintStmt(){Token kw=consume(TokenType::PRINT,"Expected 'print'");consume(TokenType::LPAREN,"Expected '('");std::unique_ptr<Expr> expr=parseExpr();consume(TokenType::RPAREN,"Expected ')'");consume(TokenType::SEMICOLON,"Expected ';'");return at(std::make_unique<PrintStmt>(std::move(expr)),kw.offset);}
+// Statements in the body recover from errors on their own, stopping at the body's '}', so a malformed
+// one only drops itself; the loop is dropped if its header or closing '}' is malformed.
+std::unique_ptr<RepeatStmt> Parser::parseRepeat(){
+    Token kw=consume(TokenType::REPEAT,"Expected 'repeat'");Token count=consume(TokenType::NUMBER,"Expected repeat count");consume(TokenType::LBRACE,"Expected '{'");
+    if(panicking)return nullptr;
+    if(count.overflowed){diagnostics.report(Phase::Syntax,count.offset,static_cast<std::uint32_t>(count.lexeme.size()),"Repeat count '"+count.lexeme+"' is out of range");panicking=true;return nullptr;}
+    auto loop=at(std::make_unique<RepeatStmt>(count.value),kw.offset);depth++;
+    while(!check(TokenType::RBRACE)&&!check(TokenType::END_OF_FILE)&&!MemoryBudget::exhausted(diagnostics,Phase::Syntax)){
+        std::unique_ptr<Stmt> stmt=parseStatement();if(panicking){panicking=false;synchronize();}else{loop->body.push_back(std::move(stmt));}
+    }
+    depth--;consume(TokenType::RBRACE,"Expected '}'");return loop;
+}
+bool Parser::parseOne(std::unique_ptr<Stmt>& stmt){
+    if(check(TokenType::END_OF_FILE)||MemoryBudget::exhausted(diagnostics,Phase::Syntax))return false;
+    panicking=false;stmt=parseStatement();if(panicking){stmt.reset();synchronize();}
+    return true;
+}
+// Consumes tokens in the same order, with the same messages, as parseStatement(); an inc chain is read
+// iteratively, recording the offset of each inc for the VM's overflow diagnostics.
+bool Parser::compile(Bytecode& bytecode,SemanticAnalyzer& analyzer){
+    bytecode=Bytecode();std::vector<std::uint32_t> incs;
+    while(!check(TokenType::END_OF_FILE)&&!MemoryBudget::exhausted(diagnostics,Phase::Syntax)){
+        panicking=false;
+        if(check(TokenType::REPEAT))return false;
+        if(check(TokenType::IDENTIFIER)){
+            Token name=consume(TokenType::IDENTIFIER,"Expected name");if(check(TokenType::LBRACKET))return false;
+            consume(TokenType::ASSIGN,"Expected '='");if(check(TokenType::LBRACKET))return false;
+            Token val=consume(TokenType::NUMBER,"Expected value");consume(TokenType::SEMICOLON,"Expected ';'");
+            if(!panicking){int slot=analyzer.declare(name.lexeme);if(inRange(val))bytecode.emitAssign(name.offset,slot,static_cast<std::int64_t>(val.value));}
+        }
+        else if(check(TokenType::PRINT)){
+            Token kw=consume(TokenType::PRINT,"Expected 'print'");consume(TokenType::LPAREN,"Expected '('");incs.clear();
+            while(!panicking&&check(TokenType::INC)){incs.push_back(current_token.offset);advance();consume(TokenType::LPAREN,"Expected '('");}
+            Token operand=current_token;bool literal=false,fits=true;
+            if(panicking){}
+            else if(check(TokenType::NUMBER)){advance();literal=true;fits=inRange(operand);}
+            else if(check(TokenType::IDENTIFIER)){advance();if(check(TokenType::LBRACKET))return false;}
+            else{error("Expected expression");}
+            for(std::size_t i=0;i<incs.size();i++)consume(TokenType::RPAREN,"Expected ')'");
+            consume(TokenType::RPAREN,"Expected ')'");consume(TokenType::SEMICOLON,"Expected ';'");
+            if(!panicking&&fits){
+                if(literal){bytecode.emitPrint(kw.offset,-1,static_cast<std::int64_t>(operand.value),incs,mode);}
+                else{int slot=analyzer.resolve(operand.lexeme,operand.offset);if(slot>=0)bytecode.emitPrint(kw.offset,slot,0,incs,mode);}
+            }
+        }
+        else{error("Expected statement");}
+        if(panicking)synchronize();
+    }
+    bytecode.register_count=static_cast<std::uint32_t>(analyzer.slotCount())+1;return true;
+}
+
+// --- Semantic Analyzer (Type & Declaration Check) ---
+namespace{
+// The variable at the bottom of an expression's inc chain, if any.
+IdentifierExpr* variableOf(Expr* expr){
+    while(IncCallExpr* inc=dynamic_cast<IncCallExpr*>(expr))expr=inc->argument.get();
+    if(IndexExpr* index=dynamic_cast<IndexExpr*>(expr))return index->array.get();
+    return dynamic_cast<IdentifierExpr*>(expr);
+}
+// Calls visit(decl) for every VarDeclStmt and visit(id) for every variable used in 'stmt', in source
+// order, including those in repeat bodies.
+template<typename Visit>void forEachName(Stmt* stmt,Visit&& visit){
+    if(VarDeclStmt* decl=dynamic_cast<VarDeclStmt*>(stmt)){visit(decl);}
+    else if(PrintStmt* print=dynamic_cast<PrintStmt*>(stmt)){if(IdentifierExpr* id=variableOf(print->expression.get()))visit(id);}
+    else if(ElementAssignStmt* store=dynamic_cast<ElementAssignStmt*>(stmt)){visit(store->target->array.get());}
+    else if(RepeatStmt* loop=dynamic_cast<RepeatStmt*>(stmt)){for(const auto& inner:loop->body)forEachName(inner.get(),visit);}
+}
+}
+bool SemanticAnalyzer::analyzeExpr(Expr* expr){
+    if(!expr)return true;
+    // Note on Optimization (O1): Constant folding is not implemented here.
+    // Optimization is set to O0 (No optimization - Base Requirement).
+    if(IdentifierExpr* id=dynamic_cast<IdentifierExpr*>(expr)){id->slot=resolve(id->name,id->offset);return id->slot>=0;}
+    else if(IncCallExpr* inc=dynamic_cast<IncCallExpr*>(expr)){return analyzeExpr(inc->argument.get());}
+    else if(IndexExpr* index=dynamic_cast<IndexExpr*>(expr)){return analyzeExpr(index->array.get());}
+    return true;
+}
+int SemanticAnalyzer::resolve(const std::string& name,std::uint32_t offset){
+    auto it=symbol_table.find(name);if(it!=symbol_table.end())return it->second;
+    diagnostics.report(Phase::Semantic,offset,static_cast<std::uint32_t>(name.size()),"Variable '"+name+"' is undeclared");return -1;
+}
+bool SemanticAnalyzer::analyzeStmt(Stmt* stmt){
+    if(MemoryBudget::exhausted(diagnostics,Phase::Semantic))return false;
+    declared.clear();return analyzeNested(stmt);
+}
+// A repeat body is checked once, in order: what it declares is declared for the rest of the body and
+// after the loop, even though a 'repeat 0' never assigns it (the Interpreter reports such a use).
+bool SemanticAnalyzer::analyzeNested(Stmt* stmt){
+    if(!stmt)return true;
+    if(VarDeclStmt* decl=dynamic_cast<VarDeclStmt*>(stmt)){auto added=symbol_table.emplace(decl->var_name,static_cast<int>(symbol_table.size()));if(added.second)declared.push_back(added.first);decl->slot=added.first->second;}
+    else if(PrintStmt* print=dynamic_cast<PrintStmt*>(stmt)){return analyzeExpr(print->expression.get());}
+    else if(ElementAssignStmt* store=dynamic_cast<ElementAssignStmt*>(stmt)){return analyzeExpr(store->target.get());}
+    else if(RepeatStmt* loop=dynamic_cast<RepeatStmt*>(stmt)){bool ok=true;for(const auto& inner:loop->body){ok=analyzeNested(inner.get())&&ok;}return ok;}
+    return true;
+}
+bool SemanticAnalyzer::analyze(Program* program){
+    if(verbose)std::cout<<"\n--- Starting Semantic Analysis (O0) ---\n";
+    if(!program)return true;
+    bool ok=true;for(const auto& stmt:program->statements){ok=analyzeStmt(stmt.get())&&ok;}
+    if(verbose&&ok)std::cout<<"Semantic analysis passed successfully.\n";
+    return ok;
+}
+// Names are keyed by views into the AST, which outlives the call. Positions count statements from 1;
+// names already in the symbol table are declared at position 0, before the program.
+bool SemanticAnalyzer::analyzeParallel(Program* program,WorkStealingPool& pool){
+    const std::size_t workers=pool.size();MemoryBudget* budget=MemoryBudget::active();
+    if(!program||workers<2||(budget&&budget->limited())||program->statements.size()<workers*1024)return analyze(program);
+    if(verbose)std::cout<<"\n--- Starting Semantic Analysis (O0, "<<workers<<" workers) ---\n";
+    struct Chunk{std::size_t begin,end;std::vector<std::pair<std::string_view,std::size_t>> first_decls;Diagnostics diagnostics;bool ok=true;};
+    const auto& statements=program->statements;std::size_t per=(statements.size()+workers-1)/workers;std::vector<Chunk> chunks(workers);
+    for(std::size_t i=0;i<workers;i++){chunks[i].begin=std::min(i*per,statements.size());chunks[i].end=std::min(chunks[i].begin+per,statements.size());}
+    pool.run(workers,[&](std::size_t task,std::size_t){
+        Chunk& chunk=chunks[task];std::unordered_set<std::string_view> seen;
+        for(std::size_t i=chunk.begin;i<chunk.end;i++){
+            forEachName(statements[i].get(),[&](auto* node){
+                if constexpr(std::is_same<decltype(node),VarDeclStmt*>::value){if(seen.insert(node->var_name).second)chunk.first_decls.push_back({node->var_name,i+1});}
+            });
+        }
+    });
+    struct Declaration{std::size_t position;int slot;};std::unordered_map<std::string_view,Declaration> declarations;
+    for(const auto& symbol:symbol_table)declarations.emplace(symbol.first,Declaration{0,symbol.second});
+    for(const Chunk& chunk:chunks){
+        for(const auto& decl:chunk.first_decls){
+            if(declarations.count(decl.first))continue;
+            auto added=symbol_table.emplace(std::string(decl.first),static_cast<int>(symbol_table.size())).first;
+            declarations.emplace(added->first,Declaration{decl.second,added->second});
+        }
+    }
+    pool.run(workers,[&](std::size_t task,std::size_t){
+        Chunk& chunk=chunks[task];std::unordered_set<std::string_view> local; // declared earlier in the same repeat
+        for(std::size_t i=chunk.begin;i<chunk.end;i++){
+            local.clear();
+            forEachName(statements[i].get(),[&](auto* node){
+                if constexpr(std::is_same<decltype(node),VarDeclStmt*>::value){node->slot=declarations.at(node->var_name).slot;local.insert(node->var_name);}
+                else{
+                    auto found=declarations.find(node->name);
+                    if(found==declarations.end()||(found->second.position>i&&!local.count(node->name))){chunk.diagnostics.report(Phase::Semantic,node->offset,static_cast<std::uint32_t>(node->name.size()),"Variable '"+node->name+"' is undeclared");chunk.ok=false;}
+                    else{node->slot=found->second.slot;}
+                }
+            });
+        }
+    });
+    bool ok=true;for(const Chunk& chunk:chunks){diagnostics.append(chunk.diagnostics);ok=ok&&chunk.ok;}
+    declared.clear();
+    if(verbose&&ok)std::cout<<"Semantic analysis passed successfully.\n";
+    return ok;
+}
+
+// --- Statement Profiler ---
+static std::atomic<Profiler*> sampling_profiler{nullptr};
+void Profiler::onSample(int){
+    Profiler* profiler=sampling_profiler.load(std::memory_order_relaxed);if(!profiler)return;
+    std::size_t i=profiler->sample_count.fetch_add(1,std::memory_order_relaxed);if(i<max_samples)profiler->samples[i]=profiler->current.load(std::memory_order_relaxed);
+}
+#if defined(__unix__)
+bool Profiler::start(){
+    if(sampling)return true;
+    Profiler* idle=nullptr;if(!sampling_profiler.compare_exchange_strong(idle,this))return false;
+    struct sigaction action{};action.sa_handler=onSample;sigemptyset(&action.sa_mask);action.sa_flags=SA_RESTART;sigaction(SIGPROF,&action,nullptr);
+    itimerval timer{};timer.it_interval.tv_usec=static_cast<suseconds_t>(sample_interval.count());timer.it_value=timer.it_interval;setitimer(ITIMER_PROF,&timer,nullptr);
+    sampling=true;return true;
+}
+void Profiler::stop(){
+    if(!sampling)return;
+    itimerval timer{};setitimer(ITIMER_PROF,&timer,nullptr);sampling_profiler.store(nullptr);sampling=false;
+}
+#else
+bool Profiler::start(){return false;}
+void Profiler::stop(){}
+#endif
+void Profiler::writeFolded(std::ostream& os,const std::string& name,const LineIndex& lines)const{
+    std::map<std::uint32_t,std::size_t> per_line; // line 0: outside statements
+    for(std::size_t i=0;i<sampleCount();i++){per_line[samples[i]==no_location?0:lines.locate(samples[i]).line]++;}
+    for(const auto& line:per_line){os<<name<<";"<<(line.first?"line "+std::to_string(line.first):std::string("(outside statements)"))<<" "<<line.second<<"\n";}
+}
+void Profiler::printSummary(std::ostream& os,const LineIndex& lines,std::size_t top)const{
+    struct Line{std::uint32_t line;std::size_t samples=0;std::uint64_t executions=0;};
+    // Indexed by line number, since a long run touches most lines.
+    std::vector<Line> per_line;std::uint64_t executed=0;std::size_t total=sampleCount(),outside=0;
+    std::uint32_t hint=1;
+    auto at=[&](std::uint32_t offset)->Line&{std::uint32_t line=hint=lines.lineOf(offset,hint);if(line>=per_line.size())per_line.resize(line+1);per_line[line].line=line;return per_line[line];};
+    for(std::size_t i=0;i<total;i++){if(samples[i]==no_location){outside++;}else{at(samples[i]).samples++;}}
+    for(const auto& entry:executions){at(entry.first).executions+=entry.second;executed+=entry.second;}
+    std::vector<Line> ranked;for(const Line& line:per_line){if(line.samples||line.executions)ranked.push_back(line);}
+    std::size_t shown=std::min(top,ranked.size());
+    std::partial_sort(ranked.begin(),ranked.begin()+static_cast<std::ptrdiff_t>(shown),ranked.end(),[](const Line& a,const Line& b){return a.samples!=b.samples?a.samples>b.samples:a.executions!=b.executions?a.executions>b.executions:a.line<b.line;});
+    os<<"Profile: "<<total<<" samples of "<<sample_interval.count()<<" us ("<<outside<<" outside statements), "<<executed<<" statements executed\n";
+    for(std::size_t i=0;i<shown;i++){
+        os<<"  line "<<ranked[i].line<<": "<<std::fixed<<std::setprecision(1)<<(total?100.0*static_cast<double>(ranked[i].samples)/static_cast<double>(total):0.0)<<std::defaultfloat<<"% of samples, "<<ranked[i].executions<<" executions\n";
+    }
+}
+
+// --- Array Kernels ---
+namespace{
+// An element passes the maximum when it is above 'limit' (max-count); it then becomes max under
+// Saturate and in+count-wrap under Wrap, where 'wrap' is 2^32 for Int32 and 0 (2^64 modulo 2^64) for
+// Int64, since the sum passes the maximum at most once.
+struct IncPlan{std::int64_t count,limit,max,wrap;Overflow overflow;};
+std::size_t inc_scalar(const std::int64_t* in,std::int64_t* out,std::size_t i,std::size_t n,const IncPlan& plan){
+    for(;i<n;i++){
+        std::int64_t v=in[i];if(v<=plan.limit){out[i]=v+plan.count;continue;}
+        if(plan.overflow==Overflow::Trap)return i;
+        out[i]=plan.overflow==Overflow::Saturate?plan.max:static_cast<std::int64_t>(static_cast<std::uint64_t>(v)+static_cast<std::uint64_t>(plan.count)-static_cast<std::uint64_t>(plan.wrap));
+    }
+    return n;
+}
+#if defined(INCLANG_X86_KERNELS)
+// A vector holding an overflowing element hands the rest to inc_scalar() under Trap, which finds it.
+__attribute__((target("avx2")))std::size_t inc_avx2(const std::int64_t* in,std::int64_t* out,std::size_t n,const IncPlan& plan){
+    const __m256i count=_mm256_set1_epi64x(plan.count),limit=_mm256_set1_epi64x(plan.limit),max=_mm256_set1_epi64x(plan.max),wrap=_mm256_set1_epi64x(plan.wrap);
+    std::size_t i=0;
+    for(;i+4<=n;i+=4){
+        __m256i v=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in+i)),over=_mm256_cmpgt_epi64(v,limit),sum=_mm256_add_epi64(v,count);
+        if(!_mm256_testz_si256(over,over)){
+            if(plan.overflow==Overflow::Trap)return inc_scalar(in,out,i,n,plan);
+            sum=plan.overflow==Overflow::Saturate?_mm256_blendv_epi8(sum,max,over):_mm256_sub_epi64(sum,_mm256_and_si256(over,wrap));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+i),sum);
+    }
+    return inc_scalar(in,out,i,n,plan);
+}
+__attribute__((target("sse4.2")))std::size_t inc_sse42(const std::int64_t* in,std::int64_t* out,std::size_t n,const IncPlan& plan){
+    const __m128i count=_mm_set1_epi64x(plan.count),limit=_mm_set1_epi64x(plan.limit),max=_mm_set1_epi64x(plan.max),wrap=_mm_set1_epi64x(plan.wrap);
+    std::size_t i=0;
+    for(;i+2<=n;i+=2){
+        __m128i v=_mm_loadu_si128(reinterpret_cast<const __m128i*>(in+i)),over=_mm_cmpgt_epi64(v,limit),sum=_mm_add_epi64(v,count);
+        if(!_mm_testz_si128(over,over)){
+            if(plan.overflow==Overflow::Trap)return inc_scalar(in,out,i,n,plan);
+            sum=plan.overflow==Overflow::Saturate?_mm_blendv_epi8(sum,max,over):_mm_sub_epi64(sum,_mm_and_si128(over,wrap));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+i),sum);
+    }
+    return inc_scalar(in,out,i,n,plan);
+}
+#endif
+}
+Isa best_isa(){
+#if defined(INCLANG_X86_KERNELS)
+    static const Isa best=__builtin_cpu_supports("avx2")?Isa::Avx2:__builtin_cpu_supports("sse4.2")?Isa::Sse42:Isa::Scalar;
+    return best;
+#else
+    return Isa::Scalar;
+#endif
+}
+const char* isa_name(Isa isa){switch(isa){case Isa::Avx2:return "AVX2";case Isa::Sse42:return "SSE4.2";default:return "scalar";}}
+std::size_t inc_elements(const std::int64_t* in,std::int64_t* out,std::size_t n,std::int64_t count,IntMode mode,Isa isa){
+    IncPlan plan{count,mode.max()-count,mode.max(),mode.width==IntWidth::Int32?std::int64_t(1)<<32:0,mode.overflow};
+#if defined(INCLANG_X86_KERNELS)
+    if(isa==Isa::Avx2)return inc_avx2(in,out,n,plan);
+    if(isa==Isa::Sse42)return inc_sse42(in,out,n,plan);
+#else
+    (void)isa;
+#endif
+    return inc_scalar(in,out,0,n,plan);
+}
+
+// --- Interpreter (Execution) ---
+bool RunLimits::step(Diagnostics& diagnostics,std::uint32_t offset){
+    ++steps;
+    if(step_limit&&steps>step_limit){diagnostics.report(Phase::Runtime,offset,0,"Step limit of "+std::to_string(step_limit)+" statements exceeded");return false;}
+    if(time_limit.count()&&steps%clock_interval==0&&std::chrono::steady_clock::now()>deadline){diagnostics.report(Phase::Runtime,offset,0,"Time limit of "+std::to_string(time_limit.count())+" ms exceeded");return false;}
+    return true;
+}
+static void incrementDecimal(std::string& digits){
+    for(std::size_t i=digits.size();i-->0;){if(digits[i]!='9'){digits[i]++;return;}digits[i]='0';}
+    digits.insert(digits.begin(),'1');
+}
+void Interpreter::reset(std::size_t slot_count){
+    if(frame.get_allocator()!=TrackingAllocator<std::int64_t,Phase::Runtime>()){frame=Slots<std::int64_t>();assigned=Slots<char>();big_frame=Slots<std::string>();array_frame=Slots<Slots<std::int64_t>>();elements=Slots<std::int64_t>();}
+    frame.assign(slot_count,0);assigned.assign(slot_count,0);big_frame.clear();array_frame.clear();limits.restart();
+}
+namespace{
+// Appends "[a, b, c]" to 'text'.
+void appendElements(std::string& text,const std::int64_t* values,std::size_t n){
+    char digits[24];text+='[';
+    for(std::size_t i=0;i<n;i++){if(i){text+=", ";}text.append(digits,std::to_chars(digits,digits+sizeof(digits),values[i]).ptr);}
+    text+=']';
+}
+}
+bool Interpreter::valueText(int slot,std::string& text)const{
+    if(slot<0||static_cast<std::size_t>(slot)>=frame.size()||!assigned[slot])return false;
+    if(assigned[slot]==3){text.clear();appendElements(text,array_frame[slot].data(),array_frame[slot].size());return true;}
+    text=assigned[slot]==2?big_frame[slot]:std::to_string(frame[slot]);return true;
+}
+// Only reached when 'value' is already the mode's maximum.
+bool Interpreter::overflow(const IncCallExpr* inc,std::int64_t& value){
+    switch(mode.overflow){
+        case Overflow::Wrap:value=mode.min();return true;
+        case Overflow::Saturate:return true;
+        default:return fail("Integer overflow in inc()",inc,3);
+    }
+}
+// The Big instantiation also tracks 'digits': when non-empty it holds the value and 'value' is unused.
+template<bool Big>bool Interpreter::evaluateExpr(Expr* expr,std::int64_t& value){
+    if(!expr)return fail("Null expression");
+    if(NumberExpr* num=dynamic_cast<NumberExpr*>(expr)){value=num->value;if(Big)digits=num->digits;return true;}
+    if(IdentifierExpr* id=dynamic_cast<IdentifierExpr*>(expr)){
+        std::size_t slot=static_cast<std::size_t>(id->slot);
+        if(id->slot<0||slot>=frame.size()||!assigned[slot]){return fail("Variable '"+id->name+"' used before assignment",id,static_cast<std::uint32_t>(id->name.size()));}
+        if(assigned[slot]==3){array_root=id;return false;}
+        value=frame[slot];
+        if(Big){if(assigned[slot]==2){digits=big_frame[slot];}else{digits.clear();}}
+        return true;
+    }
+    if(IncCallExpr* inc=dynamic_cast<IncCallExpr*>(expr)){
+        if(!evaluateExpr<Big>(inc->argument.get(),value))return false;
+        if(Big&&!digits.empty()){incrementDecimal(digits);return true;}
+        if(value<mode.max()){value+=1;return true;}
+        if(Big){digits=std::to_string(value);incrementDecimal(digits);return true;}
+        return overflow(inc,value);
+    }
+    if(IndexExpr* index=dynamic_cast<IndexExpr*>(expr)){
+        Slots<std::int64_t>* array=arrayAt(index);if(!array)return false;
+        value=(*array)[index->index];if(Big)digits.clear();
+        return true;
+    }
+    return fail("Unknown expression type",expr);
+}
+bool Interpreter::executeStmt(Stmt* stmt){
+    if(profiler)return limits.active()?execute<true,true>(stmt):execute<false,true>(stmt);
+    return limits.active()?execute<true,false>(stmt):execute<false,false>(stmt);
+}
+template<bool Limited,bool Profiled>bool Interpreter::execute(Stmt* stmt){
+    if(MemoryBudget::exhausted(diagnostics,Phase::Runtime))return false;
+    if(!stmt)return true;
+    if(Limited&&!limits.step(diagnostics,stmt->offset))return false;
+    if(!Profiled)return perform<Limited,Profiled>(stmt);
+    profiler->enter(stmt->offset);bool ok=perform<Limited,Profiled>(stmt);profiler->leave();return ok;
+}
+template<bool Limited,bool Profiled>bool Interpreter::executeAll(Program* program){
+    for(const auto& stmt:program->statements){if(!execute<Limited,Profiled>(stmt.get()))return false;}
+    return true;
+}
+template<bool Limited,bool Profiled>bool Interpreter::perform(Stmt* stmt){
+    if(VarDeclStmt* decl=dynamic_cast<VarDeclStmt*>(stmt)){
+        if(decl->slot<0)return fail("Variable '"+decl->var_name+"' has no slot");
+        if(decl->array)return assignArray(decl);
+        assign(static_cast<std::size_t>(decl->slot),*decl->initial_value);
+    }
+    else if(PrintStmt* print=dynamic_cast<PrintStmt*>(stmt)){
+        std::int64_t value;array_root=nullptr;
+        if(mode.width!=IntWidth::Big){if(!evaluateExpr<false>(print->expression.get(),value))return array_root&&printArray(print->expression.get());}
+        else{if(!evaluateExpr<true>(print->expression.get(),value))return array_root&&printArray(print->expression.get());if(!digits.empty()){*out<<"Output: "<<digits<<"\n";return true;}}
+        *out<<"Output: "<<value<<"\n";
+    }
+    else if(ElementAssignStmt* store=dynamic_cast<ElementAssignStmt*>(stmt)){return assignElement(store);}
+    else if(RepeatStmt* loop=dynamic_cast<RepeatStmt*>(stmt)){return repeat<Limited,Profiled>(loop);}
+    return true;
+}
+namespace{
+// Whether a loop's body holds nothing but loops that are empty too, so running it does nothing.
+bool isEmpty(const RepeatStmt* loop){return std::all_of(loop->body.begin(),loop->body.end(),[](const std::unique_ptr<Stmt>& stmt){const RepeatStmt* inner=dynamic_cast<const RepeatStmt*>(stmt.get());return inner&&isEmpty(inner);});}
+// Passes output through to 'target' and keeps a copy, charged to the active MemoryBudget, as long as it
+// stays within 'cap' bytes; past that, 'complete' turns false and the copy is dropped.
+class ReplayBuffer:public std::streambuf{
+private:
+    std::ostream& target;std::size_t cap;char buffer[4096];
+    void drain(){
+        std::size_t size=static_cast<std::size_t>(pptr()-pbase());
+        if(complete&&copy.size()+size<=cap){copy.append(pbase(),size);}else if(complete){complete=false;decltype(copy)().swap(copy);}
+        target.write(pbase(),static_cast<std::streamsize>(size));setp(buffer,buffer+sizeof(buffer));
+    }
+protected:
+    int overflow(int c)override{drain();if(!traits_type::eq_int_type(c,traits_type::eof())){*pptr()=traits_type::to_char_type(c);pbump(1);}return traits_type::not_eof(c);}
+    int sync()override{drain();return 0;}
+public:
+    std::basic_string<char,std::char_traits<char>,TrackingAllocator<char,Phase::Runtime>> copy;bool complete=true;
+    ReplayBuffer(std::ostream& to,std::size_t limit):target(to),cap(limit){setp(buffer,buffer+sizeof(buffer));}
+};
+constexpr std::size_t replay_limit=1<<16;
+}
+// Runs the first pass, then the second while keeping a copy of its output, and writes that copy for every
+// later pass: they all start from the same state, so they print the same text and fail, if at all, in
+// the second. A pass that prints more than 'replay_limit' bytes is not kept, and the later passes run
+// too. Runs that count steps or profile statements execute every pass, except of an empty loop, which
+// would spin without ever counting a step.
+template<bool Limited,bool Profiled>bool Interpreter::repeat(RepeatStmt* loop){
+    if(isEmpty(loop))return true;
+    auto pass=[&]{for(const auto& stmt:loop->body){if(!execute<Limited,Profiled>(stmt.get()))return false;}return true;};
+    if(Limited||Profiled){for(std::uint64_t i=0;i<loop->count;i++){if(!pass())return false;}return true;}
+    if(!loop->count)return true;
+    if(!pass())return false;
+    if(loop->count==1)return true;
+    std::ostream* target=out;ReplayBuffer buffer(*target,replay_limit);std::ostream capture(&buffer);out=&capture;bool ok=pass();capture.flush();out=target;
+    if(!buffer.complete){for(std::uint64_t i=2;ok&&i<loop->count;i++)ok=pass();return ok;}
+    const auto& text=buffer.copy;
+    if(!ok||text.empty())return ok;
+    // The remaining passes: whole blocks of about 64 KiB of copies, then the rest.
+    std::uint64_t left=loop->count-2,per_block=std::max<std::uint64_t>(1,(std::uint64_t(1)<<16)/text.size());
+    decltype(buffer.copy) block;for(std::uint64_t i=0;i<std::min(per_block,left);i++)block.append(text.data(),text.size());
+    for(;left>=per_block;left-=per_block)out->write(block.data(),static_cast<std::streamsize>(block.size()));
+    out->write(block.data(),static_cast<std::streamsize>(left*text.size()));
+    return true;
+}
+void Interpreter::assign(std::size_t slot,const NumberExpr& init){
+    if(slot>=frame.size()){frame.resize(slot+1,0);assigned.resize(slot+1,0);}
+    if(assigned[slot]==3)Slots<std::int64_t>().swap(array_frame[slot]);
+    frame[slot]=init.value;assigned[slot]=1;
+    if(!init.digits.empty()){if(big_frame.size()<frame.size())big_frame.resize(frame.size());big_frame[slot]=init.digits;assigned[slot]=2;}
+}
+void Interpreter::copySlot(const Interpreter& from,std::size_t slot){
+    if(slot>=frame.size()){frame.resize(slot+1,0);assigned.resize(slot+1,0);}
+    char state=slot<from.frame.size()?from.assigned[slot]:0;frame[slot]=state?from.frame[slot]:0;assigned[slot]=state;
+    if(state==2){if(big_frame.size()<frame.size())big_frame.resize(frame.size());big_frame[slot]=from.big_frame[slot];}
+    if(state==3){if(array_frame.size()<frame.size())array_frame.resize(frame.size());array_frame[slot].assign(from.array_frame[slot].begin(),from.array_frame[slot].end());}
+}
+// The array replaces whatever the variable held; its memory is charged when it is allocated, so a
+// memory limit stops the program at the next statement.
+bool Interpreter::assignArray(const VarDeclStmt* decl){
+    const NumberExpr& length=*decl->initial_value;std::size_t slot=static_cast<std::size_t>(decl->slot);
+    if(!length.digits.empty()||static_cast<std::uint64_t>(length.value)>max_array_length)return fail("Array length "+(length.digits.empty()?std::to_string(length.value):length.digits)+" is too large (the maximum is "+std::to_string(max_array_length)+")",&length,0);
+    if(slot>=frame.size()){frame.resize(slot+1,0);assigned.resize(slot+1,0);}
+    if(array_frame.size()<frame.size())array_frame.resize(frame.size());
+    array_frame[slot].assign(static_cast<std::size_t>(length.value),0);frame[slot]=0;assigned[slot]=3;return true;
+}
+bool Interpreter::assignElement(const ElementAssignStmt* store){
+    Slots<std::int64_t>* array=arrayAt(store->target.get());if(!array)return false;
+    const NumberExpr& value=*store->value;
+    if(!value.digits.empty())return fail("Integer literal '"+value.digits+"' is out of range for an array element",&value,static_cast<std::uint32_t>(value.digits.size()));
+    (*array)[store->target->index]=value.value;return true;
+}
+// The array 'index' refers to, or null after recording why the element does not exist.
+Interpreter::Slots<std::int64_t>* Interpreter::arrayAt(const IndexExpr* index){
+    const IdentifierExpr* id=index->array.get();std::size_t slot=static_cast<std::size_t>(id->slot);std::uint32_t length=static_cast<std::uint32_t>(id->name.size());
+    if(id->slot<0||slot>=frame.size()||!assigned[slot]){fail("Variable '"+id->name+"' used before assignment",id,length);return nullptr;}
+    if(assigned[slot]!=3){fail("Variable '"+id->name+"' is not an array",id,length);return nullptr;}
+    Slots<std::int64_t>& array=array_frame[slot];
+    if(index->index>=array.size()){fail("Index "+(index->index==UINT64_MAX?std::string("beyond 64 bits"):std::to_string(index->index))+" is out of range for '"+id->name+"' (length "+std::to_string(array.size())+")",index,length);return nullptr;}
+    return &array;
+}
+// Prints 'expr', a chain of incs around the variable evaluateExpr() stopped at, elementwise: the whole
+// chain is one inc_elements() call. A trapping element fails at the inc that takes it past the maximum,
+// counted from the inside.
+bool Interpreter::printArray(Expr* expr){
+    std::vector<const IncCallExpr*> incs; // outermost first
+    while(const IncCallExpr* inc=dynamic_cast<const IncCallExpr*>(expr)){incs.push_back(inc);expr=inc->argument.get();}
+    const Slots<std::int64_t>& array=array_frame[static_cast<std::size_t>(array_root->slot)];const std::int64_t* values=array.data();
+    if(!incs.empty()){
+        elements.resize(array.size());std::int64_t count=static_cast<std::int64_t>(incs.size());
+        std::size_t failed=inc_elements(array.data(),elements.data(),array.size(),count,mode);
+        if(failed<array.size())return fail("Integer overflow in inc() (element "+std::to_string(failed)+")",incs[incs.size()-1-static_cast<std::size_t>(mode.max()-array[failed])],3);
+        values=elements.data();
+    }
+    // Formatted in pieces of about 64 KiB, so long arrays need no text buffer of their own size.
+    std::string text="Output: [";char digits[24];
+    for(std::size_t i=0;i<array.size();i++){
+        if(i){text+=", ";}text.append(digits,std::to_chars(digits,digits+sizeof(digits),values[i]).ptr);
+        if(text.size()>=(1<<16)){out->write(text.data(),static_cast<std::streamsize>(text.size()));text.clear();}
+    }
+    text+="]\n";out->write(text.data(),static_cast<std::streamsize>(text.size()));return true;
+}
+bool Interpreter::interpret(Program* program){
+    // Note on Intermediate Representation (IR):
+    // This interpreter uses Direct AST Interpretation, skipping the optional
+    // Three-Address Code (TAC) generation for simplicity.
+    if(verbose)std::cout<<"\n--- Starting Code Execution (Direct AST Interpretation) ---\n";
+    if(!program)return true;
+    bool ok=profiler?(limits.active()?executeAll<true,true>(program):executeAll<false,true>(program)):(limits.active()?executeAll<true,false>(program):executeAll<false,false>(program));
+    if(!ok)return false;
+    if(verbose)std::cout<<"Execution finished successfully.\n";
+    return true;
+}
+
+// Per-chunk state of interpretParallel(). 'uses' is indexed by slot and only valid where 'round' is the
+// current round; 'last' is then the chunk's latest assignment to the slot, or null if it was read first
+// and not assigned since.
+namespace{
+struct SlotUse{std::uint32_t round=0;const VarDeclStmt* last=nullptr;};
+struct ParallelChunk{
+    Diagnostics diagnostics;std::ostringstream output;std::unique_ptr<Interpreter> worker;
+    std::vector<SlotUse,TrackingAllocator<SlotUse,Phase::Runtime>> uses;std::vector<std::size_t> read_first,written;std::size_t begin=0,end=0;
+    SlotUse& use(int slot,std::uint32_t round){
+        std::size_t index=static_cast<std::size_t>(slot);if(index>=uses.size())uses.resize(index+1);
+        SlotUse& entry=uses[index];if(entry.round!=round)entry={round,nullptr};return entry;
+    }
+    // A repeat body contributes what one pass of it reads first and assigns last; 'repeat 0' nothing.
+    void summarize(const Stmt* stmt,std::uint32_t round){
+        if(const VarDeclStmt* decl=dynamic_cast<const VarDeclStmt*>(stmt)){
+            if(decl->slot<0)return; // perform() reports it
+            SlotUse& entry=use(decl->slot,round);if(!entry.last)written.push_back(static_cast<std::size_t>(decl->slot));entry.last=decl;
+        }
+        else if(const PrintStmt* print=dynamic_cast<const PrintStmt*>(stmt)){
+            const IdentifierExpr* id=variableOf(print->expression.get());if(!id||id->slot<0)return;
+            std::uint32_t seen=uses.size()>static_cast<std::size_t>(id->slot)?uses[static_cast<std::size_t>(id->slot)].round:0;
+            if(seen!=round){use(id->slot,round);read_first.push_back(static_cast<std::size_t>(id->slot));}
+        }
+        else if(const RepeatStmt* loop=dynamic_cast<const RepeatStmt*>(stmt)){if(loop->count){for(const auto& inner:loop->body)summarize(inner.get(),round);}}
+    }
+};
+}
+bool Interpreter::interpretParallel(Program* program,WorkStealingPool& pool){
+    const std::size_t workers=pool.size();
+    if(!program||workers<2||limits.active()||profiler||program->arrays||program->statements.size()<workers*1024)return interpret(program);
+    if(verbose)std::cout<<"\n--- Starting Code Execution (Parallel AST Interpretation, "<<workers<<" workers) ---\n";
+    const auto& statements=program->statements;MemoryBudget* budget=MemoryBudget::active();
+    std::vector<ParallelChunk> chunks(workers);
+    for(ParallelChunk& chunk:chunks){chunk.worker=std::make_unique<Interpreter>(chunk.diagnostics,chunk.output,false,mode);chunk.worker->reset(frame.size());chunk.uses.resize(frame.size());}
+    for(std::uint32_t round=1;chunks.back().end<statements.size();round++){
+        std::size_t next=chunks.back().end,per=std::min(round_statements,(statements.size()-next+workers-1)/workers);
+        for(ParallelChunk& chunk:chunks){chunk.begin=next;chunk.end=next=std::min(next+per,statements.size());}
+        // 1. Summaries: the slots each chunk reads before assigning them, and its last assignment to each.
+        pool.run(workers,[&](std::size_t task,std::size_t){
+            MemoryScope scope(budget);ParallelChunk& chunk=chunks[task];chunk.read_first.clear();chunk.written.clear();
+            for(std::size_t i=chunk.begin;i<chunk.end;i++)chunk.summarize(statements[i].get(),round);
+        });
+        // 2. Prefix scan: this frame holds the state before each chunk while its inputs are copied out.
+        for(ParallelChunk& chunk:chunks){
+            for(std::size_t slot:chunk.read_first)chunk.worker->copySlot(*this,slot);
+            for(std::size_t slot:chunk.written)assign(slot,*chunk.uses[slot].last->initial_value);
+        }
+        // 3. Execution, then output in statement order up to the first chunk that failed.
+        pool.run(workers,[&](std::size_t task,std::size_t){
+            MemoryScope scope(budget);ParallelChunk& chunk=chunks[task];
+            for(std::size_t i=chunk.begin;i<chunk.end;i++){if(!chunk.worker->executeStmt(statements[i].get()))break;}
+        });
+        for(ParallelChunk& chunk:chunks){
+            std::string text=chunk.output.str();out->write(text.data(),static_cast<std::streamsize>(text.size()));chunk.output.str(std::string());
+            if(chunk.diagnostics.hasErrors()){diagnostics.append(chunk.diagnostics);return false;}
+        }
+    }
+    if(verbose)std::cout<<"Execution finished successfully.\n";
+    return true;
+}
+
+bool execute_source(const std::string& code,std::ostream& out,Diagnostics& diagnostics,IntMode mode){
+    Lexer lexer(code);Parser parser(lexer,diagnostics,mode);std::unique_ptr<Program> ast=parser.parse();
+    SemanticAnalyzer analyzer(diagnostics,false);analyzer.analyze(ast.get());if(diagnostics.hasErrors())return false;
+    Interpreter interpreter(diagnostics,out,false,mode);return interpreter.interpret(ast.get());
+}
+
+// --- Register VM ---
+bool Bytecode::compile(const Program& program,std::size_t slot_count,IntMode mode){
+    code.clear();inc_offsets.clear();register_count=static_cast<std::uint32_t>(slot_count)+1;if(mode.width==IntWidth::Big||program.arrays)return false;
+    code.reserve(program.statements.size()*2);std::vector<std::uint32_t> incs;
+    for(const auto& stmt:program.statements){
+        if(const VarDeclStmt* decl=dynamic_cast<const VarDeclStmt*>(stmt.get())){emitAssign(decl->offset,decl->slot,decl->initial_value->value);continue;}
+        if(dynamic_cast<const RepeatStmt*>(stmt.get())){code.clear();inc_offsets.clear();return false;}
+        const PrintStmt* print=dynamic_cast<const PrintStmt*>(stmt.get());if(!print)continue;
+        const Expr* expr=print->expression.get();incs.clear();
+        while(const IncCallExpr* inc=dynamic_cast<const IncCallExpr*>(expr)){incs.push_back(inc->offset);expr=inc->argument.get();}
+        if(const IdentifierExpr* id=dynamic_cast<const IdentifierExpr*>(expr)){emitPrint(print->offset,id->slot,0,incs,mode);}
+        else if(const NumberExpr* num=dynamic_cast<const NumberExpr*>(expr)){emitPrint(print->offset,-1,num->value,incs,mode);}
+    }
+    return true;
+}
+void Bytecode::emitPrint(std::uint32_t offset,int slot,std::int64_t literal,const std::vector<std::uint32_t>& incs,IntMode mode){
+    std::int64_t count=static_cast<std::int64_t>(incs.size());std::uint32_t first=static_cast<std::uint32_t>(inc_offsets.size());
+    if(slot>=0){
+        std::uint32_t reg=static_cast<std::uint32_t>(slot)+1;
+        if(!count){code.push_back({OpCode::PRINT,true,0,reg,0,offset,0});return;}
+        code.push_back({OpCode::ADD,true,scratch,reg,count,offset,first});
+    }
+    else{
+        if(literal<=mode.max()-count){code.push_back({OpCode::PRINTI,true,0,0,literal+count,offset,0});return;}
+        code.push_back({OpCode::LOADI,true,scratch,0,literal,offset,0});code.push_back({OpCode::ADD,false,scratch,scratch,count,offset,first});
+    }
+    inc_offsets.insert(inc_offsets.end(),incs.rbegin(),incs.rend());code.push_back({OpCode::PRINT,false,0,scratch,0,offset,0});
+}
+void Bytecode::disassemble(std::ostream& os)const{
+    for(std::size_t pc=0;pc<code.size();pc++){
+        const Instruction& ins=code[pc];os<<pc<<": ";
+        switch(ins.op){
+            case OpCode::LOADI:os<<"LOADI r"<<ins.dst<<", "<<ins.imm;break;
+            case OpCode::ADD:os<<"ADD r"<<ins.dst<<", r"<<ins.src<<", "<<ins.imm;break;
+            case OpCode::PRINT:os<<"PRINT r"<<ins.src;break;
+            case OpCode::PRINTI:os<<"PRINTI "<<ins.imm;break;
+        }
+        os<<"\n";
+    }
+}
+// Only reached when value+imm passes the mode's maximum; gives the result 'imm' inc() calls would.
+bool Vm::overflow(const Bytecode& program,const Instruction& ins,std::int64_t& value){
+    switch(mode.overflow){
+        case Overflow::Wrap:
+            if(mode.width==IntWidth::Int64){value=static_cast<std::int64_t>(static_cast<std::uint64_t>(value)+static_cast<std::uint64_t>(ins.imm));}
+            else{value=static_cast<std::int32_t>(static_cast<std::uint32_t>(value+ins.imm));}
+            return true;
+        case Overflow::Saturate:value=mode.max();return true;
+        default:{
+            // The inc that fails is the (max-value+1)-th from the inside of the print's chain.
+            diagnostics.report(Phase::Runtime,program.inc_offsets[ins.incs+static_cast<std::size_t>(mode.max()-value)],3,"Integer overflow in inc()");return false;
+        }
+    }
+}
+template<bool Checked>bool Vm::execute(const Bytecode& program,std::size_t pc){
+    std::int64_t* r=registers.data();const std::int64_t max=mode.max();
+    for(;pc<program.code.size();pc++){
+        const Instruction& ins=program.code[pc];
+        if(Checked&&ins.starts_statement&&!limits.step(diagnostics,ins.offset))return false;
+        switch(ins.op){
+            case OpCode::LOADI:r[ins.dst]=ins.imm;break;
+            case OpCode::ADD:{std::int64_t value=r[ins.src];if(value<=max-ins.imm){value+=ins.imm;}else if(!overflow(program,ins,value)){return false;}r[ins.dst]=value;break;}
+            case OpCode::PRINT:out<<"Output: "<<r[ins.src]<<"\n";break;
+            case OpCode::PRINTI:out<<"Output: "<<ins.imm<<"\n";break;
+        }
+    }
+    return true;
+}
+bool Vm::run(const Bytecode& program){
+    if(registers.get_allocator()!=TrackingAllocator<std::int64_t,Phase::Runtime>())registers=decltype(registers)();
+    registers.assign(program.register_count,0);limits.restart();if(MemoryBudget::exhausted(diagnostics,Phase::Runtime))return false;
+    return checked()?execute<true>(program,0):execute<false>(program,0);
+}
+static void printValue(void* context,std::int64_t value){*static_cast<std::ostream*>(context)<<"Output: "<<value<<"\n";}
+bool Vm::runNative(const Bytecode& program,const NativeCode& native){
+    if(registers.get_allocator()!=TrackingAllocator<std::int64_t,Phase::Runtime>())registers=decltype(registers)();
+    registers.assign(program.register_count,0);if(MemoryBudget::exhausted(diagnostics,Phase::Runtime))return false;
+    std::uint32_t pc=native.entry()(registers.data(),&out,printValue);
+    return execute<false>(program,pc);
+}
+
+// --- Columnar Execution ---
+// A row that traps keeps its old value, so the rest of its column can still be computed; later traps
+// in a row that has already failed are not reported again.
+bool ColumnarVm::run(const Bytecode& program,const std::vector<std::vector<std::int64_t>>& inputs,std::size_t rows,const std::function<void(const ColumnBlock&)>& emit){
+    std::size_t print_count=static_cast<std::size_t>(std::count_if(program.code.begin(),program.code.end(),[](const Instruction& ins){return ins.op==OpCode::PRINT||ins.op==OpCode::PRINTI;}));
+    const std::size_t width=std::max<std::size_t>(1,std::min(max_block_rows,block_values/(program.register_count+print_count)));
+    if(registers.get_allocator()!=TrackingAllocator<std::int64_t,Phase::Runtime>()){registers=Column<std::int64_t>();cells=Column<std::int64_t>();printed=Column<std::uint32_t>();}
+    registers.assign(program.register_count*width,0);cells.assign(print_count*width,0);printed.assign(width,0);
+    ColumnBlock block{0,0,{},printed.data()};for(std::size_t p=0;p<print_count;p++)block.prints.push_back(cells.data()+p*width);
+    auto column=[&](std::uint32_t reg){return registers.data()+reg*width;};
+    bool ok=true;const std::int64_t max=mode.max();
+    for(std::size_t first=0;first<rows;first+=width){
+        if(MemoryBudget::exhausted(diagnostics,Phase::Runtime))return false;
+        const std::size_t n=std::min(width,rows-first);std::uint32_t print=0;
+        for(std::size_t slot=0;slot<inputs.size();slot++)std::copy_n(inputs[slot].begin()+static_cast<std::ptrdiff_t>(first),n,column(static_cast<std::uint32_t>(slot)+1));
+        std::fill_n(printed.begin(),n,UINT32_MAX);
+        for(const Instruction& ins:program.code){
+            switch(ins.op){
+                case OpCode::LOADI:std::fill_n(column(ins.dst),n,ins.imm);break;
+                case OpCode::ADD:{
+                    const std::int64_t* src=column(ins.src);std::int64_t* dst=column(ins.dst);
+                    for(std::size_t i=0;i<n;){
+                        std::size_t failed=i+inc_elements(src+i,dst+i,n-i,ins.imm,mode);if(failed>=n)break;
+                        if(printed[failed]==UINT32_MAX){
+                            printed[failed]=print;ok=false;
+                            diagnostics.report(Phase::Runtime,program.inc_offsets[ins.incs+static_cast<std::size_t>(max-src[failed])],3,"Integer overflow in inc() (row "+std::to_string(first+failed+1)+")");
+                        }
+                        dst[failed]=src[failed];i=failed+1;
+                    }
+                    break;
+                }
+                case OpCode::PRINT:std::copy_n(column(ins.src),n,cells.data()+print*width);print++;break;
+                case OpCode::PRINTI:std::fill_n(cells.data()+print*width,n,ins.imm);print++;break;
+            }
+        }
+        block.first_row=first;block.rows=n;emit(block);
+    }
+    return ok;
+}
+
+// --- Tiered Execution ---
+#if defined(__x86_64__)&&defined(__linux__)
+namespace{
+// Emits the few x86-64 instructions NativeCode needs. The frame pointer lives in rbx, the print context
+// in r12 and the print callback in r13, all callee-saved, so calls to the callback keep them.
+// Writes straight into a mapping sized for the longest encoding of every instruction.
+class X64Emitter{
+public:
+    static constexpr std::size_t max_instruction=48,max_fixed=64; // per instruction (with its bailout stub), and prologue plus epilogue
+    std::uint8_t* begin;std::uint8_t* at;
+    explicit X64Emitter(void* memory):begin(static_cast<std::uint8_t*>(memory)),at(begin){}
+    std::size_t size()const{return static_cast<std::size_t>(at-begin);}
+    void raw(std::initializer_list<std::uint8_t> code){std::memcpy(at,code.begin(),code.size());at+=code.size();}
+    void imm32(std::uint32_t value){std::memcpy(at,&value,4);at+=4;} // x86 is little-endian, like the host
+    void imm64(std::int64_t value){std::memcpy(at,&value,8);at+=8;}
+    // An instruction with a [rbx+register*8] operand; 'field' is the ModRM reg field.
+    void frame(std::initializer_list<std::uint8_t> opcode,std::uint8_t field,std::uint32_t reg){
+        raw(opcode);std::uint32_t disp=reg*8;
+        if(disp<128){raw({static_cast<std::uint8_t>(0x43|field<<3),static_cast<std::uint8_t>(disp)});}else{raw({static_cast<std::uint8_t>(0x83|field<<3)});imm32(disp);}
+    }
+    std::size_t jump32(std::initializer_list<std::uint8_t> opcode){raw(opcode);imm32(0);return size();} // returns the end of the rel32
+    void patch(std::size_t end,std::size_t target){std::uint32_t rel=static_cast<std::uint32_t>(target-end);std::memcpy(begin+end-4,&rel,4);}
+};
+}
+bool NativeCode::compile(const Bytecode& bytecode,IntMode mode){
+    if(ready()||mode.width==IntWidth::Big||bytecode.code.size()>=UINT32_MAX||bytecode.register_count>=(1u<<28))return false;
+    if(std::any_of(bytecode.code.begin(),bytecode.code.end(),[](const Instruction& ins){return ins.op==OpCode::ADD&&ins.imm>INT32_MAX;}))return false;
+    std::size_t capacity=bytecode.code.size()*X64Emitter::max_instruction+X64Emitter::max_fixed;
+    void* mapping=mmap(nullptr,capacity,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);if(mapping==MAP_FAILED)return false;
+    X64Emitter x(mapping);std::vector<std::pair<std::size_t,std::uint32_t>> bailouts; // (jump end, instruction index)
+    x.raw({0x53,0x41,0x54,0x41,0x55});                       // push rbx; push r12; push r13
+    x.raw({0x48,0x89,0xFB,0x49,0x89,0xF4,0x49,0x89,0xD5});   // mov rbx,rdi; mov r12,rsi; mov r13,rdx
+    regions.clear();regions.push_back({0,0,no_location,"entry"});
+    for(std::size_t pc=0;pc<bytecode.code.size();pc++){
+        const Instruction& ins=bytecode.code[pc];
+        if(ins.starts_statement){regions.back().length=x.size()-regions.back().offset;regions.push_back({x.size(),0,ins.offset,Bytecode::assigns(ins)?"assign":"print"});}
+        switch(ins.op){
+            case OpCode::LOADI:
+                if(ins.imm>=INT32_MIN&&ins.imm<=INT32_MAX){x.frame({0x48,0xC7},0,ins.dst);x.imm32(static_cast<std::uint32_t>(ins.imm));}   // mov qword [rbx+dst],imm32
+                else{x.raw({0x48,0xB8});x.imm64(ins.imm);x.frame({0x48,0x89},0,ins.dst);}                                              // mov rax,imm64; mov [rbx+dst],rax
+                break;
+            case OpCode::ADD:
+                x.frame({0x48,0x8B},0,ins.src);x.raw({0x48,0x05});x.imm32(static_cast<std::uint32_t>(ins.imm));                           // mov rax,[rbx+src]; add rax,imm32
+                if(mode.width==IntWidth::Int64){bailouts.push_back({x.jump32({0x0F,0x80}),static_cast<std::uint32_t>(pc)});}               // jo bailout
+                else{x.raw({0x48,0x3D,0xFF,0xFF,0xFF,0x7F});bailouts.push_back({x.jump32({0x0F,0x8F}),static_cast<std::uint32_t>(pc)});}    // cmp rax,INT32_MAX; jg bailout
+                x.frame({0x48,0x89},0,ins.dst);break;                                                                                   // mov [rbx+dst],rax
+            case OpCode::PRINT:x.raw({0x4C,0x89,0xE7});x.frame({0x48,0x8B},6,ins.src);x.raw({0x41,0xFF,0xD5});break;                     // mov rdi,r12; mov rsi,[rbx+src]; call r13
+            case OpCode::PRINTI:
+                x.raw({0x4C,0x89,0xE7});                                                                                                // mov rdi,r12
+                if(ins.imm>=0&&ins.imm<=UINT32_MAX){x.raw({0xBE});x.imm32(static_cast<std::uint32_t>(ins.imm));}else{x.raw({0x48,0xBE});x.imm64(ins.imm);} // mov esi,imm32 / mov rsi,imm64
+                x.raw({0x41,0xFF,0xD5});break;                                                                                          // call r13
+        }
+    }
+    regions.back().length=x.size()-regions.back().offset;regions.push_back({x.size(),0,no_location,"exit"});
+    x.raw({0xB8});x.imm32(static_cast<std::uint32_t>(bytecode.code.size()));                                                  // mov eax,size
+    std::size_t epilogue=x.size();x.raw({0x41,0x5D,0x41,0x5C,0x5B,0xC3});                                               // pop r13; pop r12; pop rbx; ret
+    regions.back().length=x.size()-regions.back().offset;regions.push_back({x.size(),0,no_location,"bailouts"});
+    for(const auto& bailout:bailouts){x.patch(bailout.first,x.size());x.raw({0xB8});x.imm32(bailout.second);x.patch(x.jump32({0xE9}),epilogue);} // mov eax,pc; jmp epilogue
+    regions.back().length=x.size()-regions.back().offset;
+    if(mprotect(mapping,capacity,PROT_READ|PROT_EXEC)!=0){munmap(mapping,capacity);regions.clear();return false;}
+    memory=mapping;size=capacity;length=x.size();return true;
+}
+NativeCode::~NativeCode(){if(memory)munmap(memory,size);}
+void NativeCode::appendPerfMap(const std::string& name,const LineIndex& lines)const{
+    static std::mutex lock;std::ostringstream entries;writePerfMap(entries,name,lines);
+    std::lock_guard<std::mutex> guard(lock);std::ofstream map("/tmp/perf-"+std::to_string(getpid())+".map",std::ios::app);map<<entries.str();
+}
+#else
+bool NativeCode::compile(const Bytecode&,IntMode){return false;}
+NativeCode::~NativeCode(){}
+void NativeCode::appendPerfMap(const std::string&,const LineIndex&)const{}
+#endif
+void NativeCode::writePerfMap(std::ostream& os,const std::string& name,const LineIndex& lines)const{
+    std::uintptr_t base=reinterpret_cast<std::uintptr_t>(memory);os<<std::hex;
+    for(const Region& region:regions){
+        if(!region.length)continue;
+        os<<base+region.offset<<" "<<region.length<<" inclang:"<<name;
+        if(region.source_offset!=no_location)os<<":"<<std::dec<<lines.locate(region.source_offset).line<<std::hex;
+        os<<" "<<region.kind<<"\n";
+    }
+    os<<std::dec;
+}
+
+// --- Embedding API ---
+int Engine::SinkBuffer::overflow(int c){
+    if(sync()!=0)return traits_type::eof();
+    if(!traits_type::eq_int_type(c,traits_type::eof())){*pptr()=traits_type::to_char_type(c);pbump(1);}
+    return traits_type::not_eof(c);
+}
+int Engine::SinkBuffer::sync(){
+    std::size_t size=static_cast<std::size_t>(pptr()-pbase());
+    if(size&&sink&&*sink)(*sink)(pbase(),size);
+    setp(buffer.data(),buffer.data()+buffer.size());return 0;
+}
+std::shared_ptr<const CompiledProgram> Engine::compile(const std::string& source,const std::string& name)const{
+    auto program=std::make_shared<CompiledProgram>();program->source=source;program->mode=mode;program->name=name;
+    if(single_pass&&backend==Backend::Vm&&mode.width!=IntWidth::Big){
+        Diagnostics semantic_errors;SemanticAnalyzer analyzer(semantic_errors,false);Lexer lexer(program->source);Parser parser(lexer,program->diagnostics,mode);
+        // A repeat loop sends the whole source down the AST path instead.
+        if(parser.compile(program->bytecode,analyzer)){program->diagnostics.append(semantic_errors);program->slot_count=analyzer.slotCount();return program;}
+        program->diagnostics.clear();program->bytecode=Bytecode();
+    }
+    Lexer lexer(program->source);Parser parser(lexer,program->diagnostics,mode);program->ast=parser.parse();
+    SemanticAnalyzer analyzer(program->diagnostics,false);if(pool)analyzer.analyzeParallel(program->ast.get(),*pool);else analyzer.analyze(program->ast.get());program->slot_count=analyzer.slotCount();
+    if(backend==Backend::Vm&&program->ok())program->bytecode.compile(*program->ast,program->slot_count,mode);
+    return program;
+}
+const CompiledProgram::HotCode* CompiledProgram::promote(std::uint32_t threshold,bool perf_map)const{
+    if(runs.fetch_add(1,std::memory_order_relaxed)+1<threshold)return nullptr;
+    std::call_once(promoted,[&]{
+        auto code=std::make_unique<HotCode>();
+        if(!code->bytecode.compile(*ast,slot_count,mode))return;
+        if(code->native.compile(code->bytecode,mode)&&perf_map)code->native.appendPerfMap(name,LineIndex::of(source));
+        hot=std::move(code);
+    });
+    return hot.get();
+}
+bool Engine::run(const CompiledProgram& program,const OutputSink& sink){
+    run_diagnostics.clear();if(!program.ok())return false;
+    sink_buffer.attach(&sink);bool ok;const CompiledProgram::HotCode* hot=nullptr;
+    // A single-pass program has no AST, so it runs on the Vm whatever engine runs it.
+    if(!program.ast||(!profiler&&backend==Backend::Vm&&!program.bytecode.code.empty())){vm.setMode(program.mode);ok=vm.run(program.bytecode);}
+    else if(!profiler&&backend==Backend::Tiered&&(hot=program.promote(hot_threshold,perf_map))){
+        vm.setMode(program.mode);
+        // Runs with step or time limits stay on the Vm, which counts the steps.
+        ok=hot->native.ready()&&!vm.checked()?vm.runNative(hot->bytecode,hot->native):vm.run(hot->bytecode);
+    }
+    else{interpreter.setMode(program.mode);interpreter.reset(program.slot_count);ok=pool?interpreter.interpretParallel(program.ast.get(),*pool):interpreter.interpret(program.ast.get());}
+    out.flush();sink_buffer.attach(nullptr);return ok;
+}
+
+// --- Incremental Documents ---
+void Document::collect(const Stmt* stmt,std::vector<const VarDeclStmt*>& decls,std::vector<Use>& uses){
+    const Expr* expr=nullptr;
+    if(const VarDeclStmt* decl=dynamic_cast<const VarDeclStmt*>(stmt)){decls.push_back(decl);}
+    else if(const PrintStmt* print=dynamic_cast<const PrintStmt*>(stmt)){expr=print->expression.get();}
+    else if(const ElementAssignStmt* store=dynamic_cast<const ElementAssignStmt*>(stmt)){expr=store->target.get();}
+    else if(const RepeatStmt* loop=dynamic_cast<const RepeatStmt*>(stmt)){for(const auto& inner:loop->body)collect(inner.get(),decls,uses);}
+    while(expr){
+        if(const IdentifierExpr* id=dynamic_cast<const IdentifierExpr*>(expr)){
+            const VarDeclStmt* local=nullptr;for(const VarDeclStmt* decl:decls){if(decl->var_name==id->name)local=decl;}
+            uses.push_back({id,local});break;
+        }
+        if(const IndexExpr* index=dynamic_cast<const IndexExpr*>(expr)){expr=index->array.get();continue;}
+        const IncCallExpr* inc=dynamic_cast<const IncCallExpr*>(expr);expr=inc?inc->argument.get():nullptr;
+    }
+}
+// A use is undeclared unless some statement with a smaller key declares the name, so moving a name's
+// first declaration flips exactly the uses between the old and the new first declaration.
+void Document::registerNames(const Statement& s){
+    std::vector<const VarDeclStmt*> decls;std::vector<Use> uses;collect(s.stmt.get(),decls,uses);
+    for(const VarDeclStmt* decl:decls){
+        NameInfo& info=names[decl->var_name];std::uint64_t old_first=firstDecl(info);info.decls[s.key]=&s;
+        for(auto it=info.uses.upper_bound(s.key);it!=info.uses.end()&&it->first<=old_first;++it)undeclared.erase({it->first,decl->var_name});
+    }
+    for(const Use& use:uses){
+        if(use.second)continue; // declared earlier in the same statement
+        NameInfo& info=names[use.first->name];info.uses[s.key]=&s;if(s.key<=firstDecl(info))undeclared.insert({s.key,use.first->name});
+    }
+    if(!s.syntax_errors.empty())failed[s.key]=&s;
+}
+void Document::unregisterNames(const Statement& s){
+    std::vector<const VarDeclStmt*> decls;std::vector<Use> uses;collect(s.stmt.get(),decls,uses);
+    for(const VarDeclStmt* decl:decls){
+        NameInfo& info=names[decl->var_name];std::uint64_t old_first=firstDecl(info);info.decls.erase(s.key);std::uint64_t new_first=firstDecl(info);
+        for(auto it=info.uses.upper_bound(old_first);it!=info.uses.end()&&it->first<=new_first;++it)undeclared.insert({it->first,decl->var_name});
+    }
+    for(const Use& use:uses){if(!use.second){names[use.first->name].uses.erase(s.key);undeclared.erase({s.key,use.first->name});}}
+    for(const VarDeclStmt* decl:decls){auto it=names.find(decl->var_name);if(it!=names.end()&&it->second.decls.empty()&&it->second.uses.empty())names.erase(it);}
+    for(const Use& use:uses){auto it=names.find(use.first->name);if(it!=names.end()&&it->second.decls.empty()&&it->second.uses.empty())names.erase(it);}
+    failed.erase(s.key);
+}
+// Spreads keys for the new statements [first,first+count) evenly between their neighbours' keys. When
+// the gap is too small, a window around them that doubles in width until its keys are sparse enough is
+// renumbered (settling any pending shift inside it), in the manner of an order-maintenance list.
+void Document::assignKeys(std::size_t first,std::size_t count){
+    const std::uint64_t spacing=std::uint64_t(1)<<24;
+    for(std::size_t width=0;;width=width?width*2:8){
+        std::size_t lo=first>width?first-width:0,hi=std::min(statements.size(),first+count+width);
+        std::uint64_t low=lo?statements[lo-1]->key:0,high=hi<statements.size()?statements[hi]->key:UINT64_MAX;
+        std::uint64_t step=std::min((high-low)/(hi-lo+1),spacing);
+        if(step<(width?spacing>>8:1)&&(lo>0||hi<statements.size()))continue;
+        for(std::size_t i=lo;i<hi;i++){
+            Statement& s=*statements[i];if(i>=first&&i<first+count)continue;
+            unregisterNames(s);std::int64_t d=lag(s);s.end=static_cast<std::uint32_t>(s.end+d);s.shift+=d;
+        }
+        if(pending_key>low&&pending_key<high){pending_key=hi<statements.size()?high:UINT64_MAX;if(hi==statements.size())pending_delta=0;}
+        for(std::size_t i=lo;i<hi;i++)statements[i]->key=low+step*(i-lo+1);
+        for(std::size_t i=lo;i<hi;i++){if(i<first||i>=first+count)registerNames(*statements[i]);}
+        return;
+    }
+}
+// Re-parses from the start of statements[first] until a new statement ends, at or after 'edit_end', at
+// an offset that an old statement ended at (before the edit shifted it by 'delta'), then splices.
+void Document::reparse(std::size_t first,std::size_t edit_end,std::int64_t delta){
+    std::uint32_t pos=first?endOf(*statements[first-1]):0;std::size_t stop=statements.size();
+    std::vector<std::unique_ptr<Statement>> fresh;Diagnostics errors;Lexer lexer(source,pos);Parser parser(lexer,errors,mode);std::unique_ptr<Stmt> stmt;
+    while(parser.parseOne(stmt)){
+        // A statement that failed at end of input owns the rest of the text: appending to it changes its error.
+        auto s=std::make_unique<Statement>();s->end=!stmt&&parser.atEnd()?static_cast<std::uint32_t>(source.size()):parser.lastEnd();s->shift=0;s->key=0;s->stmt=std::move(stmt);
+        s->syntax_errors=errors.all();errors.clear();pos=s->end;fresh.push_back(std::move(s));
+        if(pos<edit_end)continue;
+        std::int64_t old_end=static_cast<std::int64_t>(pos)-delta;
+        auto it=std::lower_bound(statements.begin()+static_cast<std::ptrdiff_t>(first),statements.end(),old_end,[this](const std::unique_ptr<Statement>& s,std::int64_t end){return static_cast<std::int64_t>(endOf(*s))<end;});
+        if(it!=statements.end()&&static_cast<std::int64_t>(endOf(**it))==old_end){stop=static_cast<std::size_t>(it-statements.begin())+1;break;}
+    }
+    reparsed=fresh.size();
+    for(std::size_t i=first;i<stop;i++)unregisterNames(*statements[i]);
+    // Everything from 'stop' on moves by 'delta'. A single pending boundary has to cover both this shift
+    // and the one already pending, so the statements between the two boundaries are brought up to date;
+    // when the old boundary lies after the edit, either side of it may be settled, whichever is shorter.
+    std::size_t n=statements.size(),lagging=static_cast<std::size_t>(std::lower_bound(statements.begin(),statements.end(),pending_key,[](const std::unique_ptr<Statement>& s,std::uint64_t key){return s->key<key;})-statements.begin());
+    if(lagging>stop&&lagging-stop<=n-lagging){move(stop,lagging,delta);pending_delta+=delta;}
+    else{
+        if(lagging>stop){move(lagging,n,pending_delta);pending_delta=0;}
+        else{move(lagging,std::max(lagging,first),pending_delta);}
+        pending_delta+=delta;pending_key=stop<n?statements[stop]->key:UINT64_MAX;
+    }
+    // Splice with at most one shift of the vector's tail.
+    std::size_t count=fresh.size(),removed=stop-first,common=std::min(count,removed);
+    for(std::size_t i=0;i<common;i++)statements[first+i]=std::move(fresh[i]);
+    if(count>removed){statements.insert(statements.begin()+static_cast<std::ptrdiff_t>(stop),std::make_move_iterator(fresh.begin()+static_cast<std::ptrdiff_t>(common)),std::make_move_iterator(fresh.end()));}
+    else{statements.erase(statements.begin()+static_cast<std::ptrdiff_t>(first+count),statements.begin()+static_cast<std::ptrdiff_t>(stop));}
+    assignKeys(first,count);
+    for(std::size_t i=first;i<first+count;i++)registerNames(*statements[i]);
+}
+void Document::setText(std::string text){source=std::move(text);lines=LineIndex::of(source);statements.clear();names.clear();undeclared.clear();failed.clear();pending_key=UINT64_MAX;pending_delta=0;reparse(0,0,0);}
+void Document::applyEdit(std::uint32_t offset,std::uint32_t removed,const std::string& inserted){
+    offset=std::min<std::uint32_t>(offset,static_cast<std::uint32_t>(source.size()));removed=std::min<std::uint32_t>(removed,static_cast<std::uint32_t>(source.size())-offset);
+    source.replace(offset,removed,inserted);lines.edit(offset,removed,inserted);
+    // The statement ending exactly at 'offset' is re-parsed too: it may be an unterminated one at the end.
+    auto first=std::lower_bound(statements.begin(),statements.end(),offset,[this](const std::unique_ptr<Statement>& s,std::uint32_t at){return endOf(*s)<at;});
+    reparse(static_cast<std::size_t>(first-statements.begin()),offset+inserted.size(),static_cast<std::int64_t>(inserted.size())-static_cast<std::int64_t>(removed));
+}
+void Document::diagnostics(Diagnostics& out)const{
+    for(const auto& entry:failed){const Statement& s=*entry.second;for(const Diagnostic& d:s.syntax_errors)out.report(d.phase,d.offset==no_location?d.offset:static_cast<std::uint32_t>(d.offset+s.shift+lag(s)),d.length,d.message);}
+    // Entries are ordered by statement and then by name; a statement's uses are reported in the order
+    // collect() finds them, which is source order even across a repeat body.
+    for(auto entry=undeclared.begin();entry!=undeclared.end();){
+        auto last=entry;while(last!=undeclared.end()&&last->first==entry->first)++last;
+        const Statement& s=*names.at(entry->second).uses.at(entry->first);std::vector<const VarDeclStmt*> decls;std::vector<Use> uses;collect(s.stmt.get(),decls,uses);
+        for(const Use& use:uses){const IdentifierExpr* id=use.first;if(!use.second&&undeclared.count({entry->first,id->name}))out.report(Phase::Semantic,offsetOf(s,id),static_cast<std::uint32_t>(id->name.size()),"Variable '"+id->name+"' is undeclared");}
+        entry=last;
+    }
+}
+bool Document::loopsAround(const Stmt* stmt,const IdentifierExpr* id,std::vector<std::pair<const RepeatStmt*,std::size_t>>& loops){
+    if(const RepeatStmt* loop=dynamic_cast<const RepeatStmt*>(stmt)){
+        for(std::size_t i=0;i<loop->body.size();i++){if(loopsAround(loop->body[i].get(),id,loops)){loops.push_back({loop,i});return true;}}
+        return false;
+    }
+    std::vector<const VarDeclStmt*> decls;std::vector<Use> uses;collect(stmt,decls,uses);
+    return std::any_of(uses.begin(),uses.end(),[id](const Use& use){return use.first==id;});
+}
+// Going outwards, a loop whose body assigns the name before the use fixes its value on every pass; the
+// first loop that runs more than once and assigns it after the use carries that value into later passes.
+const VarDeclStmt* Document::carriedInto(const Stmt* stmt,const IdentifierExpr* id){
+    std::vector<std::pair<const RepeatStmt*,std::size_t>> loops;loopsAround(stmt,id,loops);
+    auto assigns=[id](const VarDeclStmt* decl){return decl->var_name==id->name;};
+    for(const auto& level:loops){
+        const auto& body=level.first->body;std::vector<const VarDeclStmt*> before,after;std::vector<Use> ignored;
+        for(std::size_t i=0;i<level.second;i++)collect(body[i].get(),before,ignored);
+        if(std::any_of(before.begin(),before.end(),assigns))return nullptr;
+        for(std::size_t i=level.second+1;i<body.size();i++)collect(body[i].get(),after,ignored);
+        auto last=std::find_if(after.rbegin(),after.rend(),assigns);
+        if(level.first->count>1&&last!=after.rend())return *last;
+    }
+    return nullptr;
+}
+bool Document::symbolAt(std::uint32_t offset,Symbol& symbol)const{
+    // The statement whose span contains 'offset', or the one ending right at it (cursor just past a name).
+    auto it=std::upper_bound(statements.begin(),statements.end(),offset,[this](std::uint32_t at,const std::unique_ptr<Statement>& s){return at<endOf(*s);});
+    std::vector<const VarDeclStmt*> decls;std::vector<Use> uses;
+    auto touches=[offset](std::uint32_t at,std::size_t length){return offset>=at&&offset<=at+length;};
+    for(int i=0;i<2;i++,--it){
+        if(it!=statements.end()&&(*it)->stmt){
+            const Statement& s=**it;decls.clear();uses.clear();collect(s.stmt.get(),decls,uses);
+            for(const VarDeclStmt* decl:decls){
+                std::uint32_t at=offsetOf(s,decl),length=static_cast<std::uint32_t>(decl->var_name.size());
+                if(touches(at,length)){symbol={decl->var_name,at,length,&s,at,decl};return true;}
+            }
+            for(const Use& use:uses){
+                const IdentifierExpr* id=use.first;std::uint32_t at=offsetOf(s,id),length=static_cast<std::uint32_t>(id->name.size());
+                if(!touches(at,length))continue;
+                symbol={id->name,at,length,nullptr,0,use.second};
+                if(use.second){symbol.declaration=&s;}
+                else{
+                    const NameInfo& info=names.at(id->name);auto decl=info.decls.lower_bound(s.key);if(decl==info.decls.begin())return true;
+                    symbol.declaration=std::prev(decl)->second;std::vector<const VarDeclStmt*> reaching;std::vector<Use> ignored;collect(symbol.declaration->stmt.get(),reaching,ignored);
+                    for(const VarDeclStmt* d:reaching){if(d->var_name==id->name)symbol.declarator=d;}
+                }
+                symbol.declaration_offset=offsetOf(*symbol.declaration,symbol.declarator);
+                if((symbol.carried=carriedInto(s.stmt.get(),id)))symbol.carried_offset=offsetOf(s,symbol.carried);
+                return true;
+            }
+        }
+        if(it==statements.begin())break;
+    }
+    return false;
+}
@@ -0,0 +1,653 @@
+#ifndef INCLANG_H
+#define INCLANG_H
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <string_view>
+#include <memory>
+#include <cstdint>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <deque>
+#include <condition_variable>
+
+// --- Tokens & AST Definitions ---
+// Note: This implementation focuses on simplicity by using C++ smart pointers
+// (std::unique_ptr) and classes, fulfilling the core compiler requirements.
+enum class TokenType{INC,PRINT,REPEAT,ASSIGN,SEMICOLON,LPAREN,RPAREN,LBRACE,RBRACE,LBRACKET,RBRACKET,NUMBER,IDENTIFIER,END_OF_FILE,UNKNOWN};
+// Locations are 32-bit byte offsets into the source, so scripts are limited to 4 GiB (a streamed input
+// stops there with an error); they are only turned into line:column through a LineIndex when a
+// diagnostic is printed.
+constexpr std::size_t max_source_size=UINT32_MAX;
+// NUMBER tokens also carry their value, converted by the lexer; 'overflowed' is set when it needs more
+// than 64 bits (the lexeme still holds every digit).
+struct Token{TokenType type;std::string lexeme;std::uint32_t offset;std::uint64_t value=0;bool overflowed=false;};
+// Nodes are charged to the thread's active MemoryBudget, if any, which a header in front of each node
+// remembers so that the delete refunds the same budget.
+struct ASTNode{std::uint32_t offset=0;virtual ~ASTNode()=default;static void* operator new(std::size_t size);static void operator delete(void* node,std::size_t size);};
+struct Expr:public ASTNode{};
+// 'digits' is only set for literals beyond 64 bits (IntWidth::Big); 'value' holds all others.
+struct NumberExpr:public Expr{std::int64_t value;std::string digits;NumberExpr(std::int64_t val):value(val){}};
+// 'slot' is the variable's frame index, filled in by the SemanticAnalyzer (-1 until resolved).
+struct IdentifierExpr:public Expr{std::string name;int slot=-1;IdentifierExpr(const std::string& n):name(n){}};
+// 'a[i]': element 'index' of the array held by 'array' (UINT64_MAX for an index beyond 64 bits).
+struct IndexExpr:public Expr{std::unique_ptr<IdentifierExpr> array;std::uint64_t index;IndexExpr(std::unique_ptr<IdentifierExpr> a,std::uint64_t i):array(std::move(a)),index(i){}};
+struct IncCallExpr:public Expr{std::unique_ptr<Expr> argument;IncCallExpr(std::unique_ptr<Expr> arg):argument(std::move(arg)){}};
+struct Stmt:public ASTNode{};
+// 'a=[n];' sets 'array', with n in 'initial_value': the variable then holds an array of n zeros.
+struct VarDeclStmt:public Stmt{std::string var_name;int slot=-1;std::unique_ptr<NumberExpr> initial_value;bool array=false;VarDeclStmt(const std::string& name,std::unique_ptr<NumberExpr> value):var_name(name),initial_value(std::move(value)){}};
+// 'a[i]=5;' stores a literal in one element of an existing array; it declares nothing.
+struct ElementAssignStmt:public Stmt{std::unique_ptr<IndexExpr> target;std::unique_ptr<NumberExpr> value;ElementAssignStmt(std::unique_ptr<IndexExpr> t,std::unique_ptr<NumberExpr> v):target(std::move(t)),value(std::move(v)){}};
+struct PrintStmt:public Stmt{std::unique_ptr<Expr> expression;PrintStmt(std::unique_ptr<Expr> expr):expression(std::move(expr)){}};
+// 'repeat N { ... }' runs its body N times. Assignments only store literals, so every pass after the
+// first starts from the state the first one left and does exactly what the second one does.
+struct RepeatStmt:public Stmt{std::uint64_t count;std::vector<std::unique_ptr<Stmt>> body;RepeatStmt(std::uint64_t n):count(n){}};
+// 'arrays' is set when some statement creates an array, which only the interpreter can run.
+struct Program:public ASTNode{std::vector<std::unique_ptr<Stmt>> statements;bool arrays=false;};
+
+// --- Integer Semantics ---
+// Values are 64-bit integers at run time and the width only sets their range. Int32 (the default) and
+// Int64 reject literals outside the range and apply the overflow policy when inc() would pass the
+// maximum, which costs one well-predicted compare per inc. Big behaves like Int64 until a value
+// outgrows 64 bits and from then on carries it as decimal digits; no policy applies to it.
+enum class IntWidth{Int32,Int64,Big};
+enum class Overflow{Trap,Wrap,Saturate};
+struct IntMode{
+    IntWidth width=IntWidth::Int32;Overflow overflow=Overflow::Trap;
+    std::int64_t max()const{return width==IntWidth::Int32?INT32_MAX:INT64_MAX;}
+    std::int64_t min()const{return width==IntWidth::Int32?INT32_MIN:INT64_MIN;}
+};
+
+// --- Array Kernels ---
+// inc() over a whole array adds the chain's depth to every element in one pass, with the overflow
+// policy applied per element. Array elements are 64-bit in every mode; under Big they behave as in
+// Int64. The kernels compare and add four elements at a time with AVX2 or two with SSE4.2, chosen at
+// run time from what the CPU supports, and fall back to a scalar loop elsewhere.
+enum class Isa{Scalar,Sse42,Avx2};
+Isa best_isa();
+const char* isa_name(Isa isa);
+// Writes in[i]+count to out[i] for all i<n, for elements in [0,mode.max()] and count>=1. Under Trap
+// it returns the index of the first element that would pass the maximum (out is then unspecified), and
+// n otherwise.
+std::size_t inc_elements(const std::int64_t* in,std::int64_t* out,std::size_t n,std::int64_t count,IntMode mode,Isa isa=best_isa());
+
+// --- Source Locations ---
+// Maps byte offsets to 1-based line:column. Line starts are collected by a newline scan (16 bytes at a
+// time where SSE2 is available), run lazily over a whole source or fed chunk by chunk while streaming.
+// A stream that has no more use for the lines before some offset can discard() them, keeping only
+// their count, so the index stays as small as the lines still referenced.
+struct SourceLocation{std::uint32_t line,column;};
+class LineIndex{
+private:
+    std::vector<std::uint32_t> line_starts{0};std::uint32_t first_line=1; // the line line_starts[0] begins
+    void addLine(std::size_t next_start){line_starts.push_back(static_cast<std::uint32_t>(next_start));}
+public:
+    static LineIndex of(const std::string& source){LineIndex index;index.scan(source.data(),source.size(),0);return index;}
+    // Records the lines that start inside data[0,size), where data[0] is at absolute offset 'base'.
+    void scan(const char* data,std::size_t size,std::size_t base);
+    SourceLocation locate(std::uint32_t offset)const;
+    // Drops the starts of the lines before the one holding 'offset'; locating an earlier offset then
+    // gives the first line kept.
+    void discard(std::uint32_t offset);
+    // locate(offset).line, checking the line 'hint' and the one after it before searching, for callers
+    // that walk offsets mostly in order and pass the previous result.
+    std::uint32_t lineOf(std::uint32_t offset,std::uint32_t hint)const{
+        for(std::uint32_t line=std::max(hint,first_line);line<=hint+1&&line-first_line<line_starts.size();line++){
+            std::size_t i=line-first_line;if(line_starts[i]<=offset&&(i+1==line_starts.size()||offset<line_starts[i+1]))return line;
+        }
+        return locate(offset).line;
+    }
+    // Inverse of locate(); out-of-range lines and columns are clamped to the end of the source. Only
+    // for indexes that discarded nothing, like edit().
+    std::uint32_t offsetOf(SourceLocation loc,std::uint32_t source_size)const;
+    // Updates the index for 'removed' bytes at 'offset' being replaced by 'inserted'.
+    void edit(std::uint32_t offset,std::uint32_t removed,std::string_view inserted);
+};
+
+// --- Diagnostics ---
+// Every phase records errors here instead of throwing, so one pass reports all of them and the error-free
+// path needs no exception handling. Storage is reserved up front; once 'limit' entries are held, further
+// errors are only counted.
+enum class Phase{Syntax,Semantic,Runtime};
+constexpr std::uint32_t no_location=UINT32_MAX;
+// Source span [offset,offset+length). 'location' is filled by Diagnostics::resolve, else when printed.
+struct Diagnostic{Phase phase;std::uint32_t offset,length;std::string message;SourceLocation location{0,0};};
+class Diagnostics{
+private:
+    std::vector<Diagnostic> entries;std::size_t limit;std::size_t dropped=0,resolved=0;
+public:
+    explicit Diagnostics(std::size_t max_errors=100):limit(max_errors){entries.reserve(max_errors);}
+    void report(Phase phase,std::uint32_t offset,std::uint32_t length,std::string message){if(entries.size()<limit){entries.push_back({phase,offset,length,std::move(message)});}else{dropped++;}}
+    void append(const Diagnostics& other){for(const Diagnostic& d:other.entries)report(d.phase,d.offset,d.length,d.message);dropped+=other.dropped;}
+    void clear(){entries.clear();dropped=0;resolved=0;}
+    // Locates the entries recorded since the last call, for callers about to discard() lines of 'lines'.
+    void resolve(const LineIndex& lines){for(;resolved<entries.size();resolved++){if(entries[resolved].offset!=no_location)entries[resolved].location=lines.locate(entries[resolved].offset);}}
+    bool hasErrors()const{return !entries.empty()||dropped;}
+    std::size_t count()const{return entries.size()+dropped;}
+    const std::vector<Diagnostic>& all()const{return entries;}
+    void print(std::ostream& os,const LineIndex& lines,const std::string& prefix="")const;
+};
+
+// --- Memory Accounting ---
+// A MemoryBudget counts the bytes held by each phase: AST nodes and VM code (Syntax), the symbol table (Semantic)
+// and the variable frame (Runtime), with current and peak values per phase and in total. It is made
+// active for a thread with a MemoryScope; AST nodes and TrackingAllocator containers created while it
+// is active charge it, so it must outlive them. Passing the limit never fails an allocation: it raises
+// a flag that the parser, analyzer and interpreter poll once per statement, and they then stop with a
+// "Memory limit" diagnostic. The overshoot is therefore at most one statement's worth.
+class MemoryBudget{
+private:
+    struct Counter{std::atomic<std::size_t> current{0},peak{0};void add(std::size_t bytes);};
+    Counter phases[3],total;std::size_t limit;std::atomic<bool> over{false},reported{false};
+public:
+    explicit MemoryBudget(std::size_t limit_bytes=SIZE_MAX):limit(limit_bytes){}
+    void charge(Phase phase,std::size_t bytes){phases[static_cast<int>(phase)].add(bytes);total.add(bytes);if(total.current.load(std::memory_order_relaxed)>limit)over.store(true,std::memory_order_relaxed);}
+    void refund(Phase phase,std::size_t bytes){phases[static_cast<int>(phase)].current.fetch_sub(bytes,std::memory_order_relaxed);total.current.fetch_sub(bytes,std::memory_order_relaxed);}
+    std::size_t peak(Phase phase)const{return phases[static_cast<int>(phase)].peak.load(std::memory_order_relaxed);}
+    std::size_t peakTotal()const{return total.peak.load(std::memory_order_relaxed);}
+    bool limited()const{return limit!=SIZE_MAX;}
+    // Starts a new measurement for the next program: peaks drop to the current usage and the limit is
+    // checked again, so memory kept for reuse (such as an Engine's frame) counts against every program.
+    void restart();
+    // Prints "Peak memory: <total> bytes (syntax <n>, semantic <n>, runtime <n>)".
+    void print(std::ostream& os)const;
+    static MemoryBudget* active();
+    // True once the active budget is over its limit. The first caller to notice records the diagnostic.
+    static bool exhausted(Diagnostics& diagnostics,Phase phase);
+    friend class MemoryScope;
+};
+class MemoryScope{
+private:
+    MemoryBudget* previous;
+public:
+    explicit MemoryScope(MemoryBudget& budget);
+    // Makes 'budget' active, or none if it is null, for threads that work on behalf of another.
+    explicit MemoryScope(MemoryBudget* budget);
+    ~MemoryScope();
+    MemoryScope(const MemoryScope&)=delete;MemoryScope& operator=(const MemoryScope&)=delete;
+};
+// A std::allocator that charges the budget active when the container was created.
+template<typename T,Phase P>struct TrackingAllocator{
+    using value_type=T;using propagate_on_container_move_assignment=std::true_type;
+    template<typename U>struct rebind{using other=TrackingAllocator<U,P>;};
+    MemoryBudget* budget;
+    TrackingAllocator():budget(MemoryBudget::active()){}
+    template<typename U>TrackingAllocator(const TrackingAllocator<U,P>& other):budget(other.budget){}
+    T* allocate(std::size_t n){if(budget)budget->charge(P,n*sizeof(T));return std::allocator<T>().allocate(n);}
+    void deallocate(T* p,std::size_t n){if(budget)budget->refund(P,n*sizeof(T));std::allocator<T>().deallocate(p,n);}
+    template<typename U>bool operator==(const TrackingAllocator<U,P>& other)const{return budget==other.budget;}
+    template<typename U>bool operator!=(const TrackingAllocator<U,P>& other)const{return budget!=other.budget;}
+};
+
+// --- Work-Stealing Thread Pool ---
+// Persistent workers that execute a bulk job of 'count' independent tasks. Tasks are dealt out in
+// contiguous blocks, one deque per worker; a worker takes its own tasks in order from the front and,
+// once they run out, steals from the back of the other deques so uneven task costs still balance.
+class WorkStealingPool{
+private:
+    struct TaskQueue{std::mutex lock;std::deque<std::size_t> tasks;};
+    std::vector<std::unique_ptr<TaskQueue>> queues;std::vector<std::thread> threads;
+    std::mutex state_lock;std::condition_variable wake,finished;
+    const std::function<void(std::size_t,std::size_t)>* job=nullptr;std::size_t generation=0,busy=0;bool stopping=false;
+    bool takeOwn(std::size_t worker,std::size_t& task);
+    bool steal(std::size_t worker,std::size_t& task);
+    void workerLoop(std::size_t worker);
+public:
+    explicit WorkStealingPool(std::size_t workers);
+    ~WorkStealingPool();
+    std::size_t size()const{return threads.size();}
+    // Calls fn(task,worker) for every task in [0,count) and returns once all of them have finished. One
+    // job runs at a time, so run() must not be called from a task or from two threads at once.
+    void run(std::size_t count,const std::function<void(std::size_t,std::size_t)>& fn);
+};
+
+// --- Lexer (Scanner) ---
+// Anything the Parser can pull tokens from: the Lexer itself, or a queue fed by a lexer thread.
+class TokenSource{public:virtual ~TokenSource()=default;virtual Token nextToken()=0;};
+class Lexer:public TokenSource{
+private:
+    // 'source' views either the caller's string (which must outlive the Lexer) or, when streaming, 'window'.
+    std::string window;std::string_view source;std::size_t current_pos=0,base_offset=0;std::istream* input=nullptr;LineIndex lines;bool indexed=false,truncated=false;
+    std::map<std::string,TokenType> keywords={{"inc",TokenType::INC},{"print",TokenType::PRINT},{"repeat",TokenType::REPEAT}};
+    bool refill();
+    std::uint32_t offset()const{return static_cast<std::uint32_t>(base_offset+current_pos);}
+    bool atEnd(){return current_pos>=source.length()&&!refill();}
+    char advance(){return atEnd()?'\0':source[current_pos++];}
+    char peek(){return atEnd()?'\0':source[current_pos];}
+    void skipWhitespace(){while(!atEnd()){char c=peek();if(c==' '||c=='\t'||c=='\r'||c=='\n'){advance();}else{break;}}}
+    Token scanIdentifier(std::uint32_t start);
+    Token scanNumber(std::uint32_t start);
+public:
+    // Lexes 'src' starting at byte 'start'; token offsets stay relative to the beginning of 'src'.
+    Lexer(const std::string& src,std::size_t start=0):source(src),current_pos(start){}
+    Lexer(std::istream& in):input(&in),indexed(true){}
+    Token nextToken()override;
+    // Line index for everything read so far. For an in-memory source it is only built on first use.
+    const LineIndex& lineIndex(){if(!indexed){lines.scan(source.data(),source.size(),0);indexed=true;}return lines;}
+    // See LineIndex::discard; streaming callers use it to keep memory bounded.
+    void discardLines(std::uint32_t before){lines.discard(before);}
+    // Records an error if a streamed input reached max_source_size; callers report it after the last token.
+    void reportTruncation(Diagnostics& diagnostics)const;
+};
+
+// --- Parser (Syntax Analysis) ---
+// On a syntax error the parser records one diagnostic, abandons the statement and resynchronizes after
+// the next ';', so later statements are still checked.
+class Bytecode;class SemanticAnalyzer;
+class Parser{
+private:
+    TokenSource& lexer;Token current_token{TokenType::UNKNOWN,"",0};Diagnostics& diagnostics;IntMode mode;bool panicking=false;std::uint32_t consumed_end=0;
+    std::size_t depth=0; // repeat bodies open around the current statement; their '}' ends error recovery
+    bool arrays=false; // whether an array has been created, for Program::arrays
+    void advance(){consumed_end=current_token.offset+static_cast<std::uint32_t>(current_token.lexeme.size());current_token=lexer.nextToken();}bool check(TokenType type)const{return current_token.type==type;}
+    void error(const std::string& msg);
+    Token consume(TokenType expected_type,const std::string& msg);
+    void synchronize(){while(!check(TokenType::END_OF_FILE)&&!check(TokenType::SEMICOLON)&&!(depth&&check(TokenType::RBRACE))){advance();}if(check(TokenType::SEMICOLON))advance();}
+    bool inRange(const Token& t);
+    std::unique_ptr<NumberExpr> number(const Token& t);
+    template<typename T>static std::unique_ptr<T> at(std::unique_ptr<T> node,std::uint32_t offset){node->offset=offset;return node;}
+    std::unique_ptr<IncCallExpr> parseIncCall();
+    std::unique_ptr<Expr> parseExpr();
+    std::unique_ptr<IndexExpr> parseIndex(const Token& name);
+    std::unique_ptr<Stmt> parseAssignment();
+    std::unique_ptr<PrintStmt> parsePrintStmt();
+    std::unique_ptr<RepeatStmt> parseRepeat();
+    std::unique_ptr<Stmt> parseStatement(){if(check(TokenType::IDENTIFIER)){return parseAssignment();}if(check(TokenType::PRINT)){return parsePrintStmt();}if(check(TokenType::REPEAT)){return parseRepeat();}error("Expected statement");return nullptr;}
+public:
+    // 'int_mode' decides which integer literals are in range.
+    Parser(TokenSource& lex,Diagnostics& diag,IntMode int_mode=IntMode()):lexer(lex),diagnostics(diag),mode(int_mode){advance();}
+    // Parses exactly one statement. A malformed one leaves 'stmt' null once its error is recorded and the
+    // input is resynchronized. Returns false at end of input.
+    bool parseOne(std::unique_ptr<Stmt>& stmt);
+    // Parses the next well-formed statement, skipping malformed ones, or returns nullptr at end of input.
+    std::unique_ptr<Stmt> parseNext(){std::unique_ptr<Stmt> stmt;while(parseOne(stmt)){if(stmt)return stmt;}return nullptr;}
+    // Offset just past the last token consumed, i.e. the end of the statement parsed last.
+    std::uint32_t lastEnd()const{return consumed_end;}
+    bool atEnd()const{return check(TokenType::END_OF_FILE);}
+    std::unique_ptr<Program> parse(){auto p=std::make_unique<Program>();while(std::unique_ptr<Stmt> stmt=parseNext()){p->statements.push_back(std::move(stmt));}p->arrays=arrays;return p;}
+    // Single-pass mode: parses the rest of the input and emits each statement to 'bytecode' as soon as it
+    // ends, with 'analyzer' numbering slots and checking declare-before-use as identifiers are consumed,
+    // so no AST node is built. Syntax errors are recorded exactly as parse() records them and semantic
+    // errors in the analyzer's Diagnostics, as analyze() would record them. Replaces 'bytecode'; not for
+    // IntWidth::Big, whose values the VM cannot hold. Returns false on reaching a 'repeat' or an array,
+    // which the VM cannot run; the input then has to be compiled again through an AST.
+    bool compile(Bytecode& bytecode,SemanticAnalyzer& analyzer);
+};
+
+// --- Semantic Analyzer (Type & Declaration Check) ---
+// Besides checking declare-before-use, the analyzer resolves every variable to a frame slot, numbered in
+// order of first declaration, so execution indexes a flat frame instead of looking names up.
+using SymbolTable=std::map<std::string,int,std::less<std::string>,TrackingAllocator<std::pair<const std::string,int>,Phase::Semantic>>;
+class SemanticAnalyzer{
+private:
+    SymbolTable symbol_table;Diagnostics& diagnostics;bool verbose;
+    std::vector<SymbolTable::iterator> declared; // names new in the last analyzeStmt()
+    bool analyzeExpr(Expr* expr);
+    bool analyzeNested(Stmt* stmt);
+public:
+    SemanticAnalyzer(Diagnostics& diag,bool trace=true):diagnostics(diag),verbose(trace){}
+    std::size_t slotCount()const{return symbol_table.size();}
+    // Returns the slot of 'name', numbering it if this is its first declaration.
+    int declare(const std::string& name){return symbol_table.emplace(name,static_cast<int>(symbol_table.size())).first->second;}
+    // Returns the slot of 'name' used at 'offset', or -1 after recording that it is undeclared.
+    int resolve(const std::string& name,std::uint32_t offset);
+    const SymbolTable& symbols()const{return symbol_table;}
+    // Returns false if the statement has errors; they are recorded and analysis can continue.
+    bool analyzeStmt(Stmt* stmt);
+    // Undeclares the names the last analyzeStmt() introduced, for callers that reject the statement.
+    void forgetLast(){for(auto it:declared)symbol_table.erase(it);declared.clear();}
+    bool analyze(Program* program);
+    // Same diagnostics and slots as analyze(), computed on 'pool' in three steps: every chunk of
+    // statements lists, in parallel, the names it declares in order of first declaration; one sequential
+    // merge numbers the slots and records where each name is first declared; then all chunks resolve
+    // their slots and check every use against that position at once, each into its own Diagnostics,
+    // which are appended in order. Short programs, and runs under a memory limit (where the point the
+    // limit is hit would differ), use analyze().
+    bool analyzeParallel(Program* program,WorkStealingPool& pool);
+};
+
+// --- Statement Profiler ---
+// Attributes run time and execution counts to source lines. The interpreter calls enter() and leave()
+// around each statement; enter() stores the statement's offset where a SIGPROF handler, firing every
+// 'sample_interval' of CPU time while start() is in effect, copies it into a preallocated sample buffer,
+// and counts executions per statement offset, so the table grows with the program rather than with the
+// statements executed, and is charged to the MemoryBudget active when the Profiler was created. Samples taken between statements (the front
+// end, in streaming mode) are attributed to no line. Only one Profiler may sample at a time; on systems
+// without SIGPROF only execution counts are collected.
+class Profiler{
+private:
+    using Counts=std::unordered_map<std::uint32_t,std::uint64_t,std::hash<std::uint32_t>,std::equal_to<std::uint32_t>,TrackingAllocator<std::pair<const std::uint32_t,std::uint64_t>,Phase::Runtime>>;
+    Counts executions;std::uint32_t last_offset=no_location;std::uint64_t* last_count=nullptr; // the entry of the statement entered last
+    std::vector<std::uint32_t> samples;std::atomic<std::uint32_t> current{no_location};std::atomic<std::size_t> sample_count{0};bool sampling=false;
+    static void onSample(int);
+public:
+    static constexpr std::size_t max_samples=1<<20;
+    static constexpr std::chrono::microseconds sample_interval{1000};
+    Profiler():samples(max_samples){}
+    ~Profiler(){stop();}
+    Profiler(const Profiler&)=delete;Profiler& operator=(const Profiler&)=delete;
+    // Returns false if sampling is unavailable or another Profiler is sampling.
+    bool start();
+    void stop();
+    void enter(std::uint32_t offset){
+        current.store(offset,std::memory_order_relaxed);
+        if(offset!=last_offset){last_count=&executions[offset];last_offset=offset;}
+        ++*last_count;
+    }
+    void leave(){current.store(no_location,std::memory_order_relaxed);}
+    std::size_t sampleCount()const{return std::min(sample_count.load(),max_samples);}
+    // Folded stacks for flamegraph.pl and similar tools, one "<name>;line <n> <samples>" per sampled line.
+    void writeFolded(std::ostream& os,const std::string& name,const LineIndex& lines)const;
+    // The 'top' lines by samples, with their share of samples and execution counts.
+    void printSummary(std::ostream& os,const LineIndex& lines,std::size_t top=10)const;
+};
+
+// --- Interpreter (Execution) ---
+// Step and wall-clock limits for one run, shared by the Interpreter and the Vm. Steps count executed
+// statements and the clock is only read every 'clock_interval' of them; 0 means no limit.
+class RunLimits{
+private:
+    std::uint64_t step_limit=0,steps=0;std::chrono::milliseconds time_limit{0};std::chrono::steady_clock::time_point deadline;
+public:
+    static constexpr std::uint64_t clock_interval=1024;
+    void set(std::uint64_t max_steps,std::chrono::milliseconds timeout){step_limit=max_steps;time_limit=timeout;restart();}
+    void restart(){steps=0;deadline=std::chrono::steady_clock::now()+time_limit;}
+    bool active()const{return step_limit||time_limit.count();}
+    // Counts one statement starting at 'offset'; returns false after recording the error once a limit is passed.
+    bool step(Diagnostics& diagnostics,std::uint32_t offset);
+};
+// Executes slot-resolved statements against a flat frame; the SemanticAnalyzer must have run first.
+class Interpreter{
+private:
+    // assigned[slot] is 0 before the first assignment, 1 for a value in 'frame', 2 for one in 'big_frame'
+    // and 3 for an array in 'array_frame'.
+    template<typename T>using Slots=std::vector<T,TrackingAllocator<T,Phase::Runtime>>;
+    Slots<std::int64_t> frame;Slots<char> assigned;Slots<std::string> big_frame;Slots<Slots<std::int64_t>> array_frame;Diagnostics& diagnostics;std::ostream* out;bool verbose;IntMode mode;
+    std::string digits; // in Big mode, the value being evaluated once it no longer fits 'value'
+    // Set when evaluateExpr() stops at a variable holding an array, which only a print can take whole.
+    const IdentifierExpr* array_root=nullptr;Slots<std::int64_t> elements;
+    RunLimits limits; // unlimited runs use the execute<false,..> instantiations, which skip the checks
+    Profiler* profiler=nullptr; // likewise, only execute<..,true> reports to it
+    template<bool Limited,bool Profiled>bool execute(Stmt* stmt);
+    template<bool Limited,bool Profiled>bool executeAll(Program* program);
+    template<bool Limited,bool Profiled>bool perform(Stmt* stmt);
+    template<bool Limited,bool Profiled>bool repeat(RepeatStmt* loop);
+    void assign(std::size_t slot,const NumberExpr& init);
+    bool assignArray(const VarDeclStmt* decl);
+    bool assignElement(const ElementAssignStmt* stmt);
+    Slots<std::int64_t>* arrayAt(const IndexExpr* index);
+    bool printArray(Expr* expr);
+    void copySlot(const Interpreter& from,std::size_t slot);
+    bool fail(const std::string& msg,const Expr* at=nullptr,std::uint32_t length=0){diagnostics.report(Phase::Runtime,at?at->offset:no_location,length,msg);return false;}
+    bool overflow(const IncCallExpr* inc,std::int64_t& value);
+    template<bool Big>bool evaluateExpr(Expr* expr,std::int64_t& value);
+public:
+    // Program output goes to 'output'; the phase banners are only printed when 'trace' is set.
+    Interpreter(Diagnostics& diag,std::ostream& output=std::cout,bool trace=true,IntMode int_mode=IntMode()):diagnostics(diag),out(&output),verbose(trace),mode(int_mode){}
+    void setMode(IntMode int_mode){mode=int_mode;}
+    // Caps the statements executed and the wall-clock time from now on; 0 means no limit. reset() starts
+    // the count and the clock again. A run that passes a limit stops with a runtime error.
+    void setLimits(std::uint64_t max_steps,std::chrono::milliseconds timeout){limits.set(max_steps,timeout);}
+    // Reports every executed statement to 'statement_profiler' (null to stop); it must outlive the runs.
+    void setProfiler(Profiler* statement_profiler){profiler=statement_profiler;}
+    // Forgets all variables. The frame's storage is kept for the next run unless a different MemoryBudget
+    // is active now, in which case it is reallocated under that budget.
+    void reset(std::size_t slot_count);
+    // Longer arrays are a runtime error rather than an allocation that may fail.
+    static constexpr std::uint64_t max_array_length=std::uint64_t(1)<<28;
+    // The variable's current value in decimal ("[1, 2]" for an array), or false if it has none.
+    bool valueText(int slot,std::string& text)const;
+    // Returns false after recording a runtime error; execution should stop there.
+    bool executeStmt(Stmt* stmt);
+    bool interpret(Program* program);
+    // Same output, diagnostics and final variables as interpret(), computed on 'pool'. Each print only
+    // depends on the latest assignment of its variable, so the statements are cut into one chunk per
+    // worker and run in three steps: every chunk finds, in parallel, the variables it reads before
+    // assigning them and the last value it assigns to each; one sequential scan over those summaries
+    // hands every chunk the values it starts from; then all chunks execute at once, each into its own
+    // buffer, and the buffers are written out in order up to the first runtime error. Chunks are
+    // processed in rounds of at most 'round_statements' per worker, which bounds the buffered output.
+    // Runs with limits or a profiler, programs with arrays and short programs use interpret(). After a
+    // runtime error the variables hold the values at the end of its round.
+    static constexpr std::size_t round_statements=1<<16;
+    bool interpretParallel(Program* program,WorkStealingPool& pool);
+};
+
+// Runs the whole pipeline without phase banners, writing only program output to 'out'. Execution is
+// skipped if parsing or analysis reported errors. Returns false if any diagnostics were recorded.
+bool execute_source(const std::string& code,std::ostream& out,Diagnostics& diagnostics,IntMode mode=IntMode());
+
+// --- Register VM ---
+// A second backend for whole, checked programs in the fixed-width modes. Register 0 is a scratch
+// register and every slot resolved by the SemanticAnalyzer is the virtual register after it. Each
+// statement compiles to at most three three-address instructions: 'x=5;' is LOADI r_x,5 and
+// 'print(inc(inc(x)));' is ADD r_t,r_x,2 then PRINT r_t, so a chain of incs costs one dispatch instead
+// of one per node. Chains on a literal that cannot overflow are folded into a single PRINTI. Code is
+// emitted one statement at a time and refers to the source only by offsets, so it can be produced
+// from an AST or straight from the Parser.
+enum class OpCode:std::uint8_t{LOADI,ADD,PRINT,PRINTI};
+// 'offset' is the source offset of the statement the instruction belongs to, for diagnostics, and
+// 'starts_statement' marks where step limits are counted. An ADD's inc() calls are listed from the
+// innermost out in Bytecode::inc_offsets, starting at 'incs'.
+struct Instruction{OpCode op;bool starts_statement;std::uint32_t dst,src;std::int64_t imm;std::uint32_t offset,incs;};
+class Bytecode{
+public:
+    static constexpr std::uint32_t scratch=0;
+    // Code is charged to the Syntax phase, like the AST it stands in for on the single-pass path.
+    template<typename T>using Code=std::vector<T,TrackingAllocator<T,Phase::Syntax>>;
+    Code<Instruction> code;Code<std::uint32_t> inc_offsets;std::uint32_t register_count=1;
+    // Returns false, leaving 'code' empty, if the program cannot run on the VM ('--bigint' values,
+    // 'repeat' loops or arrays).
+    bool compile(const Program& program,std::size_t slot_count,IntMode mode);
+    void emitAssign(std::uint32_t offset,int slot,std::int64_t value){code.push_back({OpCode::LOADI,true,static_cast<std::uint32_t>(slot)+1,0,value,offset,0});}
+    // A print of 'slot' (or of 'literal' when 'slot' is negative) wrapped in inc() calls at 'incs',
+    // given from the outermost in.
+    void emitPrint(std::uint32_t offset,int slot,std::int64_t literal,const std::vector<std::uint32_t>& incs,IntMode mode);
+    static bool assigns(const Instruction& ins){return ins.op==OpCode::LOADI&&ins.dst!=scratch;}
+    void disassemble(std::ostream& os)const;
+};
+class NativeCode;
+class Vm{
+private:
+    std::vector<std::int64_t,TrackingAllocator<std::int64_t,Phase::Runtime>> registers;Diagnostics& diagnostics;std::ostream& out;IntMode mode;RunLimits limits;
+    bool overflow(const Bytecode& program,const Instruction& ins,std::int64_t& value);
+    template<bool Checked>bool execute(const Bytecode& program,std::size_t pc);
+public:
+    Vm(Diagnostics& diag,std::ostream& output,IntMode int_mode=IntMode()):diagnostics(diag),out(output),mode(int_mode){}
+    void setMode(IntMode int_mode){mode=int_mode;}
+    // Same limits as Interpreter::setLimits; each run() starts the count and the clock again.
+    void setLimits(std::uint64_t max_steps,std::chrono::milliseconds timeout){limits.set(max_steps,timeout);}
+    // Runs from fresh registers; returns false after recording a runtime error. The registers are the
+    // only memory a run takes, so the MemoryBudget is checked once after allocating them, and runs without
+    // step or time limits skip all per-statement checks.
+    bool run(const Bytecode& program);
+    bool checked()const{return limits.active();}
+    // Runs 'native', compiled from 'program', and finishes on the VM from the instruction it bailed out at.
+    // Only used when run() would skip the checks.
+    bool runNative(const Bytecode& program,const NativeCode& native);
+};
+
+// --- Columnar Execution ---
+// Runs one Bytecode program over many rows of inputs at once. Registers become columns holding one
+// value per row of a block, and each instruction is applied to the whole block before the next, so a
+// LOADI is a fill, a chain of incs is one inc_elements() pass over the rows and a print copies a column.
+// The bound slots [0,inputs.size()) start every row from its input values instead of an assignment. A
+// row that fails stops as it would alone: the error names the row, which has no value for that print
+// or any later one, and the other rows go on. Step and time limits do not apply.
+// prints[p][i] is the value of the p-th print for row first_row+i, and exists where p<printed[i].
+struct ColumnBlock{std::size_t first_row,rows;std::vector<const std::int64_t*> prints;const std::uint32_t* printed;};
+class ColumnarVm{
+private:
+    template<typename T>using Column=std::vector<T,TrackingAllocator<T,Phase::Runtime>>;
+    Column<std::int64_t> registers,cells;Column<std::uint32_t> printed;Diagnostics& diagnostics;IntMode mode;
+public:
+    // Blocks have up to 'max_block_rows' rows, fewer when the program's registers and prints would
+    // otherwise take more than 'block_values' values.
+    static constexpr std::size_t max_block_rows=1024,block_values=std::size_t(1)<<20;
+    ColumnarVm(Diagnostics& diag,IntMode int_mode=IntMode()):diagnostics(diag),mode(int_mode){}
+    // 'inputs[s]' holds slot s's value for each of 'rows' rows, each in [0,mode.max()]. Calls 'emit' once
+    // per block, in row order; returns false if any row failed.
+    bool run(const Bytecode& program,const std::vector<std::vector<std::int64_t>>& inputs,std::size_t rows,const std::function<void(const ColumnBlock&)>& emit);
+};
+
+// --- Tiered Execution ---
+// NativeCode is Bytecode translated to x86-64 machine code in its own mapping, written first and then
+// made executable. Registers stay in the Vm's frame and PRINT calls back into C++. An ADD that would pass
+// the mode's maximum does not handle the overflow itself: the code returns that instruction's index and
+// the Vm finishes the run from there, with the same trap, wrap or saturate result. On other targets
+// compile() returns false and hot programs run on the Vm instead.
+// For profilers, the code is split into one region per statement, which writePerfMap() describes in
+// the "<start> <size> <symbol>" format perf and VTune read from /tmp/perf-<pid>.map.
+class NativeCode{
+private:
+    struct Region{std::size_t offset,length;std::uint32_t source_offset;const char* kind;}; // no_location for the entry, exit and bailout code
+    void* memory=nullptr;std::size_t size=0,length=0; // size of the mapping, of the code in it
+    std::vector<Region> regions;
+public:
+    // Returns the index of the instruction to resume at on the Vm, or the code size after finishing.
+    using Entry=std::uint32_t(*)(std::int64_t* registers,void* context,void(*print)(void* context,std::int64_t value));
+    NativeCode()=default;
+    NativeCode(const NativeCode&)=delete;NativeCode& operator=(const NativeCode&)=delete;
+    ~NativeCode();
+    bool compile(const Bytecode& bytecode,IntMode mode);
+    bool ready()const{return memory!=nullptr;}
+    Entry entry()const{return reinterpret_cast<Entry>(memory);}
+    std::size_t codeSize()const{return length;}
+    // Symbols are "inclang:<name>:<line> <statement kind>".
+    void writePerfMap(std::ostream& os,const std::string& name,const LineIndex& lines)const;
+    // Appends writePerfMap() entries to /tmp/perf-<pid>.map; safe to call from several threads. The map
+    // is never pruned, so once a program is freed its addresses may be listed again for later code.
+    void appendPerfMap(const std::string& name,const LineIndex& lines)const;
+};
+
+// --- Embedding API ---
+// An Engine compiles sources into immutable CompiledPrograms and runs them as often as needed. A
+// compiled program can be shared by several engines (one per thread); each engine keeps its frame and
+// output buffer between runs, so a repeated run allocates nothing. Output is delivered to the caller's
+// sink in chunks, and always completely before run() returns. An engine created for Backend::Vm also
+// compiles programs to Bytecode and runs them on its Vm, falling back to the AST Interpreter for
+// '--bigint' programs. Backend::Tiered starts every program on the Interpreter and counts its runs
+// across all engines; the run that reaches the hot threshold compiles it to Bytecode and NativeCode once,
+// and later runs execute the native code, so one-off programs keep the Interpreter's startup cost. With
+// setPerfMap(true), each program compiled to native code is added to /tmp/perf-<pid>.map under the name
+// given to compile().
+enum class Backend{Ast,Vm,Tiered};
+using OutputSink=std::function<void(const char* data,std::size_t size)>;
+class CompiledProgram{
+private:
+    friend class Engine;
+    std::string source;std::unique_ptr<Program> ast;std::size_t slot_count=0;IntMode mode;Diagnostics diagnostics;Bytecode bytecode;
+    // Tiered state: the run counter and the code compiled once the program turned hot.
+    struct HotCode{Bytecode bytecode;NativeCode native;};
+    mutable std::atomic<std::uint32_t> runs{0};mutable std::once_flag promoted;mutable std::unique_ptr<HotCode> hot;std::string name;
+    const HotCode* promote(std::uint32_t threshold,bool perf_map)const;
+public:
+    bool ok()const{return !diagnostics.hasErrors();}
+    const Diagnostics& errors()const{return diagnostics;}
+    const std::string& text()const{return source;}
+    void printErrors(std::ostream& os)const{diagnostics.print(os,LineIndex::of(source));}
+};
+class Engine{
+private:
+    // Collects interpreter output in a reusable buffer and hands it to the current sink when full.
+    class SinkBuffer:public std::streambuf{
+    private:
+        std::vector<char> buffer;const OutputSink* sink=nullptr;
+    protected:
+        int overflow(int c)override;
+        int sync()override;
+    public:
+        SinkBuffer():buffer(8192){setp(buffer.data(),buffer.data()+buffer.size());}
+        void attach(const OutputSink* target){sink=target;}
+    };
+    SinkBuffer sink_buffer;std::ostream out{&sink_buffer};Diagnostics run_diagnostics;Interpreter interpreter{run_diagnostics,out,false};Vm vm{run_diagnostics,out};IntMode mode;Backend backend;std::uint32_t hot_threshold=2;bool perf_map=false,single_pass=false;Profiler* profiler=nullptr;WorkStealingPool* pool=nullptr;
+public:
+    // Programs are compiled for 'int_mode' and always run with the mode they were compiled for.
+    explicit Engine(IntMode int_mode=IntMode(),Backend engine_backend=Backend::Ast):mode(int_mode),backend(engine_backend){}
+    // 'name' identifies the program in profiler symbol maps.
+    std::shared_ptr<const CompiledProgram> compile(const std::string& source,const std::string& name="<input>")const;
+    // Returns false if the program did not compile or failed at run time; see runErrors().
+    bool run(const CompiledProgram& program,const OutputSink& sink);
+    // Backend::Tiered: the run of a program, counted over all engines, from which native code is used.
+    void setHotThreshold(std::uint32_t runs){hot_threshold=runs;}
+    void setPerfMap(bool enabled){perf_map=enabled;}
+    // Backend::Vm: compiles later sources with Parser::compile, straight to Bytecode without an AST,
+    // except in IntWidth::Big. Such programs always run on the Vm, even with a profiler or pool set or
+    // when shared with an engine for another backend.
+    void setSinglePass(bool enabled){single_pass=enabled;}
+    // Profiles later runs statement by statement, which always runs them on the Interpreter.
+    void setProfiler(Profiler* statement_profiler){profiler=statement_profiler;interpreter.setProfiler(statement_profiler);}
+    // Analyzes programs with SemanticAnalyzer::analyzeParallel and runs those that stay on the Interpreter
+    // with Interpreter::interpretParallel, on 'workers' (null to stop); the pool must outlive the engine's
+    // use of it and must not be the one calling compile() or run().
+    void setPool(WorkStealingPool* workers){pool=workers;}
+    // Limits every later run; see Interpreter::setLimits.
+    void setLimits(std::uint64_t max_steps,std::chrono::milliseconds timeout){interpreter.setLimits(max_steps,timeout);vm.setLimits(max_steps,timeout);}
+    const Diagnostics& runErrors()const{return run_diagnostics;}
+};
+
+// --- Incremental Documents ---
+// A parsed and checked source that is edited in place, for editor integration. An edit re-lexes and
+// re-parses only the top-level statements it touches: parsing restarts at the statement containing the
+// edit and stops at the first statement end that lines up with an old one, and every other Stmt node is
+// reused. Statements tile the text (each spans from the previous statement's end to its own). The
+// statements after an edit are moved lazily: one pending shift covers everything from some statement
+// on, so an edit only pays for the statements between it and the previous edit. Declare-before-use is
+// tracked per name from the sets of declaring and using statements, so an edit only revisits uses of
+// the names it touched. Statements are ordered by sparse 64-bit keys, so inserting statements
+// renumbers nothing until a gap between two keys runs out.
+class Document{
+public:
+    // Positions are stored as parsed and may lag behind edits; read them through the Document.
+    struct Statement{std::uint32_t end;std::int64_t shift;std::uint64_t key;std::unique_ptr<Stmt> stmt;std::vector<Diagnostic> syntax_errors;};
+    // An identifier in the text and the declaration that reaches it (nullptr when it is undeclared).
+    // 'declarator' is the assignment that declares it: the last one of the name in 'declaration', or an
+    // earlier one in the same repeat body. For a use in a repeat body that assigns the name after it,
+    // 'carried' is the last such assignment, whose value the use sees from the loop's second pass on.
+    struct Symbol{std::string name;std::uint32_t offset,length;const Statement* declaration;std::uint32_t declaration_offset;const VarDeclStmt* declarator;const VarDeclStmt* carried=nullptr;std::uint32_t carried_offset=0;};
+private:
+    struct NameInfo{std::map<std::uint64_t,const Statement*> decls,uses;};
+    std::string source;LineIndex lines;std::vector<std::unique_ptr<Statement>> statements;std::map<std::string,NameInfo> names;
+    std::set<std::pair<std::uint64_t,std::string>> undeclared; // (using statement key, name), in source order
+    std::map<std::uint64_t,const Statement*> failed; // statements with syntax errors
+    std::uint64_t pending_key=UINT64_MAX;std::int64_t pending_delta=0; // statements keyed from 'pending_key' on lag by 'pending_delta'
+    std::size_t reparsed=0;IntMode mode; // literals are checked against the mode's range
+    std::int64_t lag(const Statement& s)const{return s.key>=pending_key?pending_delta:0;}
+    std::uint32_t endOf(const Statement& s)const{return static_cast<std::uint32_t>(s.end+lag(s));}
+    void move(std::size_t from,std::size_t to,std::int64_t delta){for(std::size_t i=from;i<to;i++){statements[i]->end=static_cast<std::uint32_t>(statements[i]->end+delta);statements[i]->shift+=delta;}}
+    static std::uint64_t firstDecl(const NameInfo& info){return info.decls.empty()?UINT64_MAX:info.decls.begin()->first;}
+    // A use is paired with the assignment before it in the same statement that declares it (inside a
+    // repeat body), or null when it depends on earlier statements.
+    using Use=std::pair<const IdentifierExpr*,const VarDeclStmt*>;
+    static void collect(const Stmt* stmt,std::vector<const VarDeclStmt*>& decls,std::vector<Use>& uses);
+    // Lists the repeat loops around 'id' in 'stmt', innermost first, each with the body index holding it.
+    static bool loopsAround(const Stmt* stmt,const IdentifierExpr* id,std::vector<std::pair<const RepeatStmt*,std::size_t>>& loops);
+    static const VarDeclStmt* carriedInto(const Stmt* stmt,const IdentifierExpr* id);
+    void registerNames(const Statement& s);
+    void unregisterNames(const Statement& s);
+    void assignKeys(std::size_t first,std::size_t count);
+    void reparse(std::size_t first,std::size_t edit_end,std::int64_t delta);
+public:
+    explicit Document(std::string text="",IntMode int_mode=IntMode()):mode(int_mode){setText(std::move(text));}
+    void setText(std::string text);
+    // Replaces 'removed' bytes at 'offset' with 'inserted'.
+    void applyEdit(std::uint32_t offset,std::uint32_t removed,const std::string& inserted);
+    const std::string& text()const{return source;}
+    const LineIndex& lineIndex()const{return lines;}
+    std::uint32_t offsetOf(const Statement& s,const ASTNode* node)const{return static_cast<std::uint32_t>(node->offset+s.shift+lag(s));}
+    std::size_t statementCount()const{return statements.size();}
+    // Number of statements parsed by the last setText/applyEdit.
+    std::size_t lastReparseCount()const{return reparsed;}
+    // Syntax errors in source order, followed by undeclared-variable errors in source order.
+    void diagnostics(Diagnostics& out)const;
+    // Finds the identifier (declared or used) touching 'offset'.
+    bool symbolAt(std::uint32_t offset,Symbol& symbol)const;
+};
+
+#endif
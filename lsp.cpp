@@ -0,0 +1,208 @@
+#include "lsp.h"
+#include "inclang.h"
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string_view>
+
+namespace{
+// --- JSON ---
+// Just enough JSON for LSP traffic: incoming messages are parsed into a small tree, replies are
+// written as strings with quote() escaping.
+struct Json{
+    enum class Kind{Null,Bool,Number,String,Array,Object};
+    Kind kind=Kind::Null;bool boolean=false;double number=0;std::string text;std::vector<Json> items;std::vector<std::pair<std::string,Json>> fields;
+    const Json& operator[](const std::string& key)const{static const Json null;for(const auto& f:fields){if(f.first==key)return f.second;}return null;}
+    bool isNull()const{return kind==Kind::Null;}
+    std::uint32_t u32()const{return number>0?static_cast<std::uint32_t>(number):0;}
+};
+class JsonParser{
+private:
+    std::string_view s;std::size_t pos=0;
+    void skipWhitespace(){while(pos<s.size()&&(s[pos]==' '||s[pos]=='\t'||s[pos]=='\r'||s[pos]=='\n'))pos++;}
+    bool literal(std::string_view word){if(s.substr(pos,word.size())!=word)return false;pos+=word.size();return true;}
+    bool hex4(unsigned& code){if(pos+4>s.size())return false;auto r=std::from_chars(s.data()+pos,s.data()+pos+4,code,16);if(r.ptr!=s.data()+pos+4)return false;pos+=4;return true;}
+    static void appendUtf8(std::string& out,unsigned code){
+        if(code<0x80){out+=static_cast<char>(code);}
+        else if(code<0x800){out+=static_cast<char>(0xC0|(code>>6));out+=static_cast<char>(0x80|(code&0x3F));}
+        else if(code<0x10000){out+=static_cast<char>(0xE0|(code>>12));out+=static_cast<char>(0x80|((code>>6)&0x3F));out+=static_cast<char>(0x80|(code&0x3F));}
+        else{out+=static_cast<char>(0xF0|(code>>18));out+=static_cast<char>(0x80|((code>>12)&0x3F));out+=static_cast<char>(0x80|((code>>6)&0x3F));out+=static_cast<char>(0x80|(code&0x3F));}
+    }
+    bool string(std::string& out){
+        pos++; // opening quote
+        while(pos<s.size()){
+            char c=s[pos++];
+            if(c=='"')return true;
+            if(c!='\\'){out+=c;continue;}
+            if(pos>=s.size())return false;
+            switch(s[pos++]){
+                case'"':out+='"';break;case'\\':out+='\\';break;case'/':out+='/';break;case'b':out+='\b';break;
+                case'f':out+='\f';break;case'n':out+='\n';break;case'r':out+='\r';break;case't':out+='\t';break;
+                case'u':{unsigned code=0;if(!hex4(code))return false;
+                    unsigned low=0;if(code>=0xD800&&code<0xDC00&&literal("\\u")&&hex4(low))code=0x10000+((code-0xD800)<<10)+(low-0xDC00);
+                    appendUtf8(out,code);break;}
+                default:return false;
+            }
+        }
+        return false;
+    }
+    bool value(Json& out,int depth){
+        skipWhitespace();if(pos>=s.size()||depth>64)return false;
+        char c=s[pos];
+        if(c=='{'){
+            out.kind=Json::Kind::Object;pos++;skipWhitespace();if(pos<s.size()&&s[pos]=='}'){pos++;return true;}
+            while(true){
+                skipWhitespace();if(pos>=s.size()||s[pos]!='"')return false;
+                std::string key;if(!string(key))return false;
+                skipWhitespace();if(!literal(":"))return false;
+                out.fields.emplace_back(std::move(key),Json());if(!value(out.fields.back().second,depth+1))return false;
+                skipWhitespace();if(literal("}"))return true;if(!literal(","))return false;
+            }
+        }
+        if(c=='['){
+            out.kind=Json::Kind::Array;pos++;skipWhitespace();if(pos<s.size()&&s[pos]==']'){pos++;return true;}
+            while(true){
+                out.items.emplace_back();if(!value(out.items.back(),depth+1))return false;
+                skipWhitespace();if(literal("]"))return true;if(!literal(","))return false;
+            }
+        }
+        if(c=='"'){out.kind=Json::Kind::String;return string(out.text);}
+        if(literal("true")){out.kind=Json::Kind::Bool;out.boolean=true;return true;}
+        if(literal("false")){out.kind=Json::Kind::Bool;return true;}
+        if(literal("null"))return true;
+        // The message body is a std::string, so strtod always stops at its terminating NUL.
+        const char* start=s.data()+pos;char* end=nullptr;out.number=std::strtod(start,&end);
+        if(end==start)return false;
+        out.kind=Json::Kind::Number;pos+=static_cast<std::size_t>(end-start);return true;
+    }
+public:
+    explicit JsonParser(const std::string& text):s(text){}
+    bool parse(Json& out){if(!value(out,0))return false;skipWhitespace();return pos==s.size();}
+};
+std::string quote(std::string_view text){
+    std::string out="\"";
+    for(char c:text){
+        switch(c){
+            case'"':out+="\\\"";break;case'\\':out+="\\\\";break;case'\n':out+="\\n";break;case'\r':out+="\\r";break;case'\t':out+="\\t";break;
+            default:if(static_cast<unsigned char>(c)<0x20){char buf[8];std::snprintf(buf,sizeof(buf),"\\u%04x",c);out+=buf;}else{out+=c;}
+        }
+    }
+    return out+"\"";
+}
+// Request ids are echoed back exactly as received (integer or string).
+std::string idText(const Json& id){
+    if(id.kind==Json::Kind::String)return quote(id.text);
+    if(id.kind==Json::Kind::Number)return std::to_string(static_cast<long long>(id.number));
+    return "null";
+}
+
+// --- Language Server ---
+class LanguageServer{
+private:
+    std::ostream& out;IntMode mode;std::map<std::string,Document> documents;bool shutdown_requested=false;
+    void send(const std::string& body){out<<"Content-Length: "<<body.size()<<"\r\n\r\n"<<body;out.flush();}
+    void reply(const Json& id,const std::string& result){send("{\"jsonrpc\":\"2.0\",\"id\":"+idText(id)+",\"result\":"+result+"}");}
+    void replyError(const Json& id,int code,const std::string& message){send("{\"jsonrpc\":\"2.0\",\"id\":"+idText(id)+",\"error\":{\"code\":"+std::to_string(code)+",\"message\":"+quote(message)+"}}");}
+    static std::string position(const Document& doc,std::uint32_t offset){SourceLocation loc=doc.lineIndex().locate(offset);return "{\"line\":"+std::to_string(loc.line-1)+",\"character\":"+std::to_string(loc.column-1)+"}";}
+    static std::string range(const Document& doc,std::uint32_t offset,std::uint32_t length){return "{\"start\":"+position(doc,offset)+",\"end\":"+position(doc,offset+length)+"}";}
+    static std::uint32_t offsetAt(const Document& doc,const Json& position){return doc.lineIndex().offsetOf({position["line"].u32()+1,position["character"].u32()+1},static_cast<std::uint32_t>(doc.text().size()));}
+    Document* find(const Json& params){auto it=documents.find(params["textDocument"]["uri"].text);return it==documents.end()?nullptr:&it->second;}
+    void publish(const std::string& uri,const Document* doc);
+    void change(Document& doc,const Json& changes);
+    std::string definition(const Json& params);
+    std::string hover(const Json& params);
+public:
+    LanguageServer(std::ostream& output,IntMode int_mode):out(output),mode(int_mode){}
+    // Returns false once the client sent 'exit'.
+    bool handle(const Json& message);
+    void rejectMalformed(){replyError(Json(),-32700,"Parse error");}
+    int exitCode()const{return shutdown_requested?0:1;}
+};
+void LanguageServer::publish(const std::string& uri,const Document* doc){
+    std::string items;
+    if(doc){
+        Diagnostics diagnostics;doc->diagnostics(diagnostics);
+        for(const Diagnostic& d:diagnostics.all()){
+            std::uint32_t at=d.offset==no_location?0:d.offset;
+            if(!items.empty())items+=",";
+            items+="{\"range\":"+range(*doc,at,d.offset==no_location?0:d.length)+",\"severity\":1,\"source\":\"inclang\",\"message\":"+quote(d.message)+"}";
+        }
+    }
+    send("{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":"+quote(uri)+",\"diagnostics\":["+items+"]}}");
+}
+// Ranged changes go through Document::applyEdit and only reparse what they touch; a change without a
+// range replaces the whole text.
+void LanguageServer::change(Document& doc,const Json& changes){
+    for(const Json& c:changes.items){
+        const Json& r=c["range"];
+        if(r.isNull()){doc.setText(c["text"].text);continue;}
+        std::uint32_t start=offsetAt(doc,r["start"]),end=offsetAt(doc,r["end"]);
+        if(end<start)std::swap(start,end);
+        doc.applyEdit(start,end-start,c["text"].text);
+    }
+}
+std::string LanguageServer::definition(const Json& params){
+    const Document* doc=find(params);Document::Symbol symbol;
+    if(!doc||!doc->symbolAt(offsetAt(*doc,params["position"]),symbol)||!symbol.declaration)return "null";
+    return "{\"uri\":"+quote(params["textDocument"]["uri"].text)+",\"range\":"+range(*doc,symbol.declaration_offset,symbol.length)+"}";
+}
+// The value a variable holds at the hovered point is the one its reaching declaration assigned; in a
+// repeat body that assigns it again further on, later passes see that value instead, which is shown too.
+// An array shows as it was created, "[n]", whatever elements were stored since.
+std::string LanguageServer::hover(const Json& params){
+    const Document* doc=find(params);Document::Symbol symbol;
+    if(!doc||!doc->symbolAt(offsetAt(*doc,params["position"]),symbol))return "null";
+    std::string text=symbol.name+": undeclared";
+    if(symbol.declaration){
+        SourceLocation loc=doc->lineIndex().locate(symbol.declaration_offset);
+        auto value=[](const VarDeclStmt& decl){const NumberExpr& init=*decl.initial_value;std::string digits=init.digits.empty()?std::to_string(init.value):init.digits;return decl.array?"["+digits+"]":digits;};
+        text=symbol.name+" = "+value(*symbol.declarator)+" (declared at line "+std::to_string(loc.line)+")";
+        if(symbol.carried)text+="; "+value(*symbol.carried)+" on later passes (assigned at line "+std::to_string(doc->lineIndex().locate(symbol.carried_offset).line)+")";
+    }
+    return "{\"contents\":{\"kind\":\"plaintext\",\"value\":"+quote(text)+"},\"range\":"+range(*doc,symbol.offset,symbol.length)+"}";
+}
+bool LanguageServer::handle(const Json& message){
+    const std::string& method=message["method"].text;const Json& id=message["id"];const Json& params=message["params"];
+    bool request=!id.isNull();
+    if(method=="initialize"){reply(id,"{\"capabilities\":{\"textDocumentSync\":{\"openClose\":true,\"change\":2},\"definitionProvider\":true,\"hoverProvider\":true},\"serverInfo\":{\"name\":\"inclang\"}}");}
+    else if(method=="textDocument/didOpen"){const std::string& uri=params["textDocument"]["uri"].text;documents.erase(uri);Document& doc=documents.try_emplace(uri,params["textDocument"]["text"].text,mode).first->second;publish(uri,&doc);}
+    else if(method=="textDocument/didChange"){if(Document* doc=find(params)){change(*doc,params["contentChanges"]);publish(params["textDocument"]["uri"].text,doc);}}
+    else if(method=="textDocument/didClose"){const std::string& uri=params["textDocument"]["uri"].text;documents.erase(uri);publish(uri,nullptr);}
+    else if(method=="textDocument/definition"){reply(id,definition(params));}
+    else if(method=="textDocument/hover"){reply(id,hover(params));}
+    else if(method=="shutdown"){shutdown_requested=true;reply(id,"null");}
+    else if(method=="exit"){return false;}
+    else if(request){replyError(id,-32601,"Method not found: "+method);}
+    return true;
+}
+// Headers end at an empty line; only Content-Length is used. A body longer than 'max_message' is skipped
+// without being stored, and returned as 'oversized'.
+constexpr std::size_t max_message=std::size_t(64)<<20;
+bool readMessage(std::istream& in,std::string& body,bool& oversized){
+    std::string line;std::size_t length=0;bool has_length=false;
+    while(std::getline(in,line)){
+        if(!line.empty()&&line.back()=='\r')line.pop_back();
+        if(line.empty()){if(has_length)break;continue;}
+        const std::string header="Content-Length:";
+        if(line.compare(0,header.size(),header)==0){std::size_t i=header.size();while(i<line.size()&&line[i]==' ')i++;has_length=std::from_chars(line.data()+i,line.data()+line.size(),length).ec==std::errc();}
+    }
+    if(!has_length)return false;
+    if((oversized=length>max_message)){
+        for(std::size_t left=length;left;left-=static_cast<std::size_t>(in.gcount())){in.ignore(static_cast<std::streamsize>(std::min(left,max_message)));if(!in.gcount())return false;}
+        return true;
+    }
+    body.assign(length,'\0');in.read(&body[0],static_cast<std::streamsize>(length));
+    return static_cast<std::size_t>(in.gcount())==length;
+}
+} // namespace
+
+int run_lsp(std::istream& in,std::ostream& out,IntMode mode){
+    LanguageServer server(out,mode);std::string body;bool oversized=false;
+    while(readMessage(in,body,oversized)){
+        Json message;
+        if(oversized||!JsonParser(body).parse(message)){server.rejectMalformed();continue;}
+        if(!server.handle(message))break;
+    }
+    return server.exitCode();
+}
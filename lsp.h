@@ -0,0 +1,15 @@
+#ifndef INCLANG_LSP_H
+#define INCLANG_LSP_H
+#include <iostream>
+#include "inclang.h"
+
+// --- Language Server ---
+// A Language Server Protocol endpoint over stdio: JSON-RPC messages framed by Content-Length headers,
+// no sockets. Each open file is kept as a Document, so didChange only reparses the edited statements and
+// diagnostics, go-to-definition and hover are answered from cached per-file state. Columns are counted
+// in bytes, which equal UTF-16 code units for IncLang's ASCII sources. Documents are checked for 'mode',
+// so literals are in range exactly when they would be in a run with the same options.
+// Returns the process exit code: 0 after 'shutdown' then 'exit', 1 otherwise.
+int run_lsp(std::istream& in,std::ostream& out,IntMode mode=IntMode());
+
+#endif
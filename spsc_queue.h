@@ -0,0 +1,46 @@
+#ifndef INCLANG_SPSC_QUEUE_H
+#define INCLANG_SPSC_QUEUE_H
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// --- Lock-Free SPSC Queue ---
+// Bounded ring buffer for exactly one producer thread and one consumer thread, used to hand token and
+// statement batches between pipeline stages. The capacity is rounded up to a power of two; head and
+// tail only ever grow, so full/empty never need a spare slot.
+constexpr std::size_t cache_line_size=64;
+template<typename T>class SpscQueue{
+private:
+    // Each side owns one cache line holding its own index plus a cached copy of the other side's
+    // index. The shared line is only re-read when the cached copy says the queue looks full/empty.
+    struct alignas(cache_line_size) ProducerSide{std::atomic<std::size_t> tail{0};std::size_t cached_head=0;};
+    struct alignas(cache_line_size) ConsumerSide{std::atomic<std::size_t> head{0};std::size_t cached_tail=0;};
+    std::vector<T> slots;std::size_t mask;ProducerSide producer;ConsumerSide consumer;
+    static std::size_t roundUp(std::size_t n){std::size_t p=1;while(p<n)p<<=1;return p;}
+    std::size_t freeSlots(std::size_t t,std::size_t wanted){std::size_t n=slots.size()-(t-producer.cached_head);if(n<wanted){producer.cached_head=consumer.head.load(std::memory_order_acquire);n=slots.size()-(t-producer.cached_head);}return n;}
+    std::size_t usedSlots(std::size_t h,std::size_t wanted){std::size_t n=consumer.cached_tail-h;if(n<wanted){consumer.cached_tail=producer.tail.load(std::memory_order_acquire);n=consumer.cached_tail-h;}return n;}
+public:
+    explicit SpscQueue(std::size_t capacity):slots(roundUp(capacity)),mask(roundUp(capacity)-1){}
+    SpscQueue(const SpscQueue&)=delete;SpscQueue& operator=(const SpscQueue&)=delete;
+    std::size_t capacity()const{return slots.size();}
+    // Moves 'item' into the queue only on success, so a failed push leaves it untouched for a retry.
+    bool tryPush(T& item){std::size_t t=producer.tail.load(std::memory_order_relaxed);if(freeSlots(t,1)==0)return false;slots[t&mask]=std::move(item);producer.tail.store(t+1,std::memory_order_release);return true;}
+    bool tryPop(T& item){std::size_t h=consumer.head.load(std::memory_order_relaxed);if(usedSlots(h,1)==0)return false;item=std::move(slots[h&mask]);consumer.head.store(h+1,std::memory_order_release);return true;}
+    // Batch variants publish all moved items with a single release store. They return how many of the
+    // 'count' items were transferred; untransferred items are left in place.
+    std::size_t tryPushBatch(T* items,std::size_t count){
+        std::size_t t=producer.tail.load(std::memory_order_relaxed);std::size_t n=freeSlots(t,count);if(n>count)n=count;
+        for(std::size_t i=0;i<n;i++){slots[(t+i)&mask]=std::move(items[i]);}
+        if(n)producer.tail.store(t+n,std::memory_order_release);
+        return n;
+    }
+    std::size_t tryPopBatch(T* items,std::size_t count){
+        std::size_t h=consumer.head.load(std::memory_order_relaxed);std::size_t n=usedSlots(h,count);if(n>count)n=count;
+        for(std::size_t i=0;i<n;i++){items[i]=std::move(slots[(h+i)&mask]);}
+        if(n)consumer.head.store(h+n,std::memory_order_release);
+        return n;
+    }
+};
+
+#endif
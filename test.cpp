@@ -5,119 +5,684 @@
 #include <stdexcept>
 #include <memory>
 #include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <filesystem>
+#include <random>
+#include <cstdio>
+#include <cctype>
+#include <charconv>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include "inclang.h"
+#include "spsc_queue.h"
+#include "lsp.h"
 
-// --- Tokens & AST Definitions ---
-// Note: This implementation focuses on simplicity by using C++ smart pointers 
-// (std::unique_ptr) and classes, fulfilling the core compiler requirements.
-enum class TokenType{INC,PRINT,ASSIGN,SEMICOLON,LPAREN,RPAREN,NUMBER,IDENTIFIER,END_OF_FILE,UNKNOWN};
-struct Token{TokenType type;std::string lexeme;int line;};
-struct ASTNode{virtual ~ASTNode()=default;};
-struct Expr:public ASTNode{};
-struct NumberExpr:public Expr{int value;NumberExpr(int val):value(val){}};
-struct IdentifierExpr:public Expr{std::string name;IdentifierExpr(const std::string& n):name(n){}};
-struct IncCallExpr:public Expr{std::unique_ptr<Expr> argument;IncCallExpr(std::unique_ptr<Expr> arg):argument(std::move(arg)){}};
-struct Stmt:public ASTNode{};
-struct VarDeclStmt:public Stmt{std::string var_name;std::unique_ptr<NumberExpr> initial_value;VarDeclStmt(const std::string& name,std::unique_ptr<NumberExpr> value):var_name(name),initial_value(std::move(value)){}};
-struct PrintStmt:public Stmt{std::unique_ptr<Expr> expression;PrintStmt(std::unique_ptr<Expr> expr):expression(std::move(expr)){}};
-struct Program:public ASTNode{std::vector<std::unique_ptr<Stmt>> statements;};
-
-// --- Lexer (Scanner) ---
-class Lexer{
+// --- Global Options ---
+// '--int32' (default), '--int64' or '--bigint' select the value width and '--trap' (default), '--wrap' or
+// '--saturate' the overflow policy. '--memory-limit N[k|m|g]' caps the bytes each program may hold and
+// '--stats' reports its peak memory. '--max-steps N' and '--timeout MS' cap the statements each program
+// executes and its run time. '--vm' runs '--precompute' and '--batch' programs on the register VM and
+// '--jit' compiles them to native code; '--single-pass' compiles them for the VM straight from the
+// parser, without an AST; '--perf-map' lists native code in /tmp/perf-<pid>.map for perf.
+// '--profile FILE' profiles '--stream' and '--precompute' runs by source line, writing folded stacks to
+// FILE and a summary to stderr. '--threads N' checks '--precompute' programs and runs them on the
+// interpreter over N threads. They may be given anywhere and apply to every mode.
+IntMode int_mode;std::size_t memory_limit=SIZE_MAX;bool show_stats=false,single_pass=false;std::uint64_t max_steps=0;std::chrono::milliseconds timeout{0};Backend backend=Backend::Ast;bool perf_map=false;std::string profile_path;std::size_t threads=1;
+bool parse_size(const std::string& text,std::size_t& bytes){
+    std::size_t used=0;unsigned long long value;try{value=std::stoull(text,&used);}catch(const std::exception&){return false;}
+    std::size_t shift=0;
+    if(used+1==text.size()){std::size_t unit=std::string("kmg").find(static_cast<char>(std::tolower(static_cast<unsigned char>(text[used]))));if(unit!=std::string::npos){shift=10*(unit+1);used++;}}
+    if(used!=text.size()||text[0]=='-'||(shift&&value>(SIZE_MAX>>shift)))return false;
+    bytes=static_cast<std::size_t>(value)<<shift;return true;
+}
+// Consumes the option at args[i] (and its value) and returns the number of arguments used, 0 if
+// args[i] is not a global option, or -1 if its value is missing or malformed.
+int parse_global_option(const std::vector<std::string>& args,std::size_t i){
+    static const std::map<std::string,IntWidth> widths={{"--int32",IntWidth::Int32},{"--int64",IntWidth::Int64},{"--bigint",IntWidth::Big}};
+    static const std::map<std::string,Overflow> policies={{"--trap",Overflow::Trap},{"--wrap",Overflow::Wrap},{"--saturate",Overflow::Saturate}};
+    const std::string& arg=args[i];
+    if(widths.count(arg)){int_mode.width=widths.at(arg);return 1;}
+    if(policies.count(arg)){int_mode.overflow=policies.at(arg);return 1;}
+    if(arg=="--stats"){show_stats=true;return 1;}
+    if(arg=="--vm"){backend=Backend::Vm;return 1;}
+    if(arg=="--jit"){backend=Backend::Tiered;return 1;}
+    if(arg=="--single-pass"){backend=Backend::Vm;single_pass=true;return 1;}
+    if(arg=="--perf-map"){perf_map=true;return 1;}
+    if(arg=="--profile"){if(i+1>=args.size())return -1;profile_path=args[i+1];return 2;}
+    if(arg=="--memory-limit"){return i+1<args.size()&&parse_size(args[i+1],memory_limit)?2:-1;}
+    if(arg=="--max-steps"||arg=="--timeout"||arg=="--threads"){
+        std::size_t value;if(i+1>=args.size()||args[i+1].find_first_not_of("0123456789")!=std::string::npos||!parse_size(args[i+1],value))return -1;
+        if(arg=="--threads"){if(value==0||value>1024)return -1;threads=value;}
+        else if(arg=="--max-steps")max_steps=value;else timeout=std::chrono::milliseconds(value);
+        return 2;
+    }
+    return 0;
+}
+// '--jit' programs run once, so they are compiled to native code on their first run.
+void configure_engine(Engine& engine){engine.setLimits(max_steps,timeout);engine.setHotThreshold(1);engine.setPerfMap(perf_map);engine.setSinglePass(single_pass);}
+// Writes the '--profile' results for the script 'name'.
+void report_profile(const Profiler& profiler,const std::string& name,const LineIndex& lines){
+    std::ofstream folded(profile_path,std::ios::trunc);if(!folded){std::cerr<<"Error: cannot write '"<<profile_path<<"'\n";}else{profiler.writeFolded(folded,name,lines);}
+    profiler.printSummary(std::cerr,lines);
+}
+
+// --- Whole-Program Precomputation ---
+// IncLang programs read no input, so their whole output is fixed at compile time. The program is
+// evaluated once into a byte blob which is cached next to the script as '<script>.incout', keyed by
+// a hash of the source and the integer mode. Later runs with an unchanged source replay the blob with a
+// single write, unless a limit or '--stats' asks for the run itself.
+std::uint64_t hashSource(const std::string& src){std::uint64_t h=14695981039346656037ULL;for(unsigned char c:src){h^=c;h*=1099511628211ULL;}return h;}
+bool readFile(const std::string& path,std::string& contents){std::ifstream in(path,std::ios::binary);if(!in)return false;std::ostringstream ss;ss<<in.rdbuf();contents=ss.str();return true;}
+class Precomputer{
 private:
-    std::string source;int current_pos=0;int line_num=1;
-    std::map<std::string,TokenType> keywords={{"inc",TokenType::INC},{"print",TokenType::PRINT}};
-    char advance(){return(current_pos<source.length())?source[current_pos++]:'\0';}
-    char peek()const{return(current_pos<source.length())?source[current_pos]:'\0';}
-    void skipWhitespace(){while(current_pos<source.length()){char c=peek();if(c==' '||c=='\t'||c=='\r'){advance();}else if(c=='\n'){line_num++;advance();}else{break;}}}
-    Token scanIdentifier(){std::string lexeme;while(std::isalpha(peek())||std::isdigit(peek())||peek()=='_'){lexeme+=advance();}if(keywords.count(lexeme)){return{keywords[lexeme],lexeme,line_num};}return{TokenType::IDENTIFIER,lexeme,line_num};}
-    Token scanNumber(){std::string lexeme;while(std::isdigit(peek())){lexeme+=advance();}return{TokenType::NUMBER,lexeme,line_num};}
+    // Cache file layout: "INCOUT <hash> <size>\n" followed by exactly <size> output bytes.
+    static bool loadBlob(const std::string& path,std::uint64_t hash,std::string& blob){
+        std::ifstream in(path,std::ios::binary);if(!in)return false;std::string magic;std::uint64_t stored=0;std::size_t size=0;
+        if(!(in>>magic>>stored>>size)||magic!="INCOUT"||stored!=hash||in.get()!='\n')return false;
+        // A truncated or corrupt entry is a miss, before its size is trusted for an allocation.
+        std::streampos start=in.tellg();in.seekg(0,std::ios::end);
+        if(start<0||in.tellg()-start!=static_cast<std::streamoff>(size))return false;
+        in.seekg(start);blob.resize(size);return static_cast<bool>(in.read(&blob[0],static_cast<std::streamsize>(size)))||size==0;
+    }
+    static void storeBlob(const std::string& path,std::uint64_t hash,const std::string& blob){std::ofstream out(path,std::ios::binary|std::ios::trunc);if(out){out<<"INCOUT "<<hash<<" "<<blob.size()<<"\n";out.write(blob.data(),static_cast<std::streamsize>(blob.size()));}}
 public:
-    Lexer(const std::string& src):source(src){}
-    Token nextToken(){
-        skipWhitespace();if(current_pos>=source.length()){return{TokenType::END_OF_FILE,"",line_num};}char c=advance();
-        if(std::isalpha(c)){current_pos--;return scanIdentifier();}if(std::isdigit(c)){current_pos--;return scanNumber();}
-        switch(c){case'=':return{TokenType::ASSIGN,"=",line_num};case';':return{TokenType::SEMICOLON,";",line_num};case'(':return{TokenType::LPAREN,"(",line_num};case')':return{TokenType::RPAREN,")",line_num};default:return{TokenType::UNKNOWN,std::string(1,c),line_num};}
+    // Runs the full pipeline once with output captured into 'blob'.
+    static bool evaluate(const std::string& source,const std::string& name,std::string& blob,Diagnostics& diagnostics){
+        MemoryBudget budget(memory_limit);MemoryScope scope(budget);Engine engine(int_mode,backend);configure_engine(engine);std::shared_ptr<const CompiledProgram> program=engine.compile(source,name);bool ok=program->ok();
+        std::unique_ptr<WorkStealingPool> pool;if(threads>1){pool=std::make_unique<WorkStealingPool>(threads);engine.setPool(pool.get());}
+        Profiler profiler;if(!profile_path.empty()){engine.setProfiler(&profiler);profiler.start();}
+        blob.clear();if(ok){ok=engine.run(*program,[&](const char* data,std::size_t size){blob.append(data,size);});diagnostics.append(engine.runErrors());}
+        else diagnostics.append(program->errors());
+        if(!profile_path.empty()){profiler.stop();report_profile(profiler,name,LineIndex::of(source));}
+        if(show_stats)budget.print(std::cerr);
+        return ok;
+    }
+    // Returns the program output for 'script', reusing the cached blob when the source hash matches. A
+    // program that fails at run time writes the output it printed before the error to stdout, ahead of
+    // its diagnostics, as '--stream' does; that output is not cached.
+    static bool outputFor(const std::string& script,std::string& blob){
+        std::string source;if(!readFile(script,source)){std::cerr<<"Error: cannot read '"<<script<<"'\n";return false;}
+        std::uint64_t hash=(hashSource(source)^(static_cast<std::uint64_t>(int_mode.width)<<4|static_cast<std::uint64_t>(int_mode.overflow)))*1099511628211ULL;std::string cache_path=script+".incout";
+        const bool observed=max_steps||timeout.count()||memory_limit!=SIZE_MAX||show_stats||!profile_path.empty()||perf_map;
+        if(!observed&&loadBlob(cache_path,hash,blob))return true;
+        Diagnostics diagnostics;
+        if(!evaluate(source,script,blob,diagnostics)){std::cout.write(blob.data(),static_cast<std::streamsize>(blob.size()));std::cout.flush();diagnostics.print(std::cerr,LineIndex::of(source));return false;}
+        storeBlob(cache_path,hash,blob);return true;
     }
 };
+int run_precomputed(const std::string& script){std::string blob;if(!Precomputer::outputFor(script,blob))return 1;std::cout.write(blob.data(),static_cast<std::streamsize>(blob.size()));std::cout.flush();return 0;}
+
+// --- Streaming Execution ---
+// Lexes, parses, checks and executes one statement at a time straight from a file or pipe, so memory
+// is bounded by the number of distinct variables instead of the script length. Declare-before-use only
+// looks backwards, so checking each statement as it arrives gives the same verdict as a full pass;
+// the difference is that statements before the first error have already run when it is reported.
+// After an error nothing more is executed, but the rest of the input is still checked. Diagnostics are
+// located as soon as each statement is done and the line index then drops the lines before it, except
+// under '--profile', whose report needs the lines of every statement executed.
+int run_stream(std::istream& in,const std::string& name){
+    MemoryBudget budget(memory_limit);MemoryScope scope(budget);Diagnostics diagnostics;Lexer lexer(in);Parser parser(lexer,diagnostics,int_mode);SemanticAnalyzer analyzer(diagnostics,false);Interpreter interpreter(diagnostics,std::cout,false,int_mode);interpreter.setLimits(max_steps,timeout);
+    const bool profiling=!profile_path.empty();Profiler profiler;if(profiling){interpreter.setProfiler(&profiler);profiler.start();}
+    while(std::unique_ptr<Stmt> stmt=parser.parseNext()){
+        if(analyzer.analyzeStmt(stmt.get())&&!diagnostics.hasErrors()){interpreter.executeStmt(stmt.get());}
+        diagnostics.resolve(lexer.lineIndex());if(!profiling)lexer.discardLines(stmt->offset);
+    }
+    lexer.reportTruncation(diagnostics);std::cout.flush();diagnostics.print(std::cerr,lexer.lineIndex());if(show_stats)budget.print(std::cerr);
+    if(profiling){profiler.stop();report_profile(profiler,name,lexer.lineIndex());}
+    return diagnostics.hasErrors()?1:0;
+}
+int run_stream(const std::string& path){if(path=="-")return run_stream(std::cin,"<stdin>");std::ifstream in(path,std::ios::binary);if(!in){std::cerr<<"Error: cannot read '"<<path<<"'\n";return 1;}return run_stream(in,path);}
 
-// --- Parser (Syntax Analysis) ---
-class Parser{
+// --- Pipelined Execution ---
+// Runs Lexer, Parser, SemanticAnalyzer and Interpreter as four threads connected by SPSC channels of
+// batches, so one large script keeps several cores busy and throughput approaches that of the slowest
+// stage. Each checking stage keeps its own diagnostics; a stage that finds an error forwards a null
+// statement as a barrier, after which the executor stops running statements but keeps draining, as
+// in --stream. Diagnostics are printed syntax first, then semantic, then runtime, as in run_test.
+template<typename T>class Channel{
 private:
-    Lexer& lexer;Token current_token;
-    void advance(){current_token=lexer.nextToken();}bool check(TokenType type)const{return current_token.type==type;}
-    Token consume(TokenType expected_type,const std::string& msg){if(check(expected_type)){Token t=current_token;advance();return t;}throw std::runtime_error("Syntax Error: "+msg+" (Found '"+current_token.lexeme+"') at line "+std::to_string(current_token.line));}
-    std::unique_ptr<IncCallExpr> parseIncCall(){consume(TokenType::INC,"Expected 'inc'");consume(TokenType::LPAREN,"Expected '('");std::unique_ptr<Expr> arg=parseExpr();consume(TokenType::RPAREN,"Expected ')'");return std::make_unique<IncCallExpr>(std::move(arg));}
-    std::unique_ptr<Expr> parseExpr(){
-        if(check(TokenType::NUMBER)){Token t=consume(TokenType::NUMBER,"Expected number");return std::make_unique<NumberExpr>(std::stoi(t.lexeme));}
-        if(check(TokenType::IDENTIFIER)){return std::make_unique<IdentifierExpr>(consume(TokenType::IDENTIFIER,"Expected identifier").lexeme);}
-        if(check(TokenType::INC)){return parseIncCall();}
-        throw std::runtime_error("Syntax Error: Expected expression");
-    }
-    std::unique_ptr<VarDeclStmt> parseVarDecl(){Token name=consume(TokenType::IDENTIFIER,"Expected name");consume(TokenType::ASSIGN,"Expected '='");Token val=consume(TokenType::NUMBER,"Expected value");consume(TokenType::SEMICOLON,"Expected ';'");return std::make_unique<VarDeclStmt>(name.lexeme,std::make_unique<NumberExpr>(std::stoi(val.lexeme)));}
-    std::unique_ptr<PrintStmt> parsePrintStmt(){consume(TokenType::PRINT,"Expected 'print'");consume(TokenType::LPAREN,"Expected '('");std::unique_ptr<Expr> expr=parseExpr();consume(TokenType::RPAREN,"Expected ')'");consume(TokenType::SEMICOLON,"Expected ';'");return std::make_unique<PrintStmt>(std::move(expr));}
-    std::unique_ptr<Stmt> parseStatement(){if(check(TokenType::IDENTIFIER)){return parseVarDecl();}if(check(TokenType::PRINT)){return parsePrintStmt();}throw std::runtime_error("Syntax Error: Expected statement");}
+    SpscQueue<T> queue;
 public:
-    Parser(Lexer& lex):lexer(lex){advance();}
-    std::unique_ptr<Program> parse(){auto p=std::make_unique<Program>();while(!check(TokenType::END_OF_FILE)){p->statements.push_back(parseStatement());}return p;}
+    explicit Channel(std::size_t capacity):queue(capacity){}
+    void send(T& item){while(!queue.tryPush(item)){std::this_thread::yield();}}
+    void receive(T& item){while(!queue.tryPop(item)){std::this_thread::yield();}}
 };
-
-// --- Semantic Analyzer (Type & Declaration Check) ---
-class SemanticAnalyzer{
+using TokenBatch=std::vector<Token>;
+using StmtBatch=std::vector<std::unique_ptr<Stmt>>; // an empty batch marks the end of the stream
+class ChannelTokenSource:public TokenSource{
 private:
-    std::map<std::string,bool> symbol_table; 
-    void analyzeExpr(Expr* expr){
-        if(!expr)return;
-        // Note on Optimization (O1): Constant folding is not implemented here. 
-        // Optimization is set to O0 (No optimization - Base Requirement).
-        if(IdentifierExpr* id=dynamic_cast<IdentifierExpr*>(expr)){if(symbol_table.find(id->name)==symbol_table.end()){throw std::runtime_error("Semantic Error: Variable '"+id->name+"' is undeclared.");}}
-        else if(IncCallExpr* inc=dynamic_cast<IncCallExpr*>(expr)){analyzeExpr(inc->argument.get());}
-    }
-    void analyzeStmt(Stmt* stmt){
-        if(!stmt)return;
-        if(VarDeclStmt* decl=dynamic_cast<VarDeclStmt*>(stmt)){symbol_table[decl->var_name]=true;}
-        else if(PrintStmt* print=dynamic_cast<PrintStmt*>(stmt)){analyzeExpr(print->expression.get());}
-    }
+    Channel<TokenBatch>& channel;TokenBatch batch;std::size_t next=0;
 public:
-    void analyze(Program* program){std::cout<<"\n--- Starting Semantic Analysis (O0) ---\n";if(!program)return;for(const auto& stmt:program->statements){analyzeStmt(stmt.get());}std::cout<<"Semantic analysis passed successfully.\n";}
+    ChannelTokenSource(Channel<TokenBatch>& ch):channel(ch){}
+    Token nextToken()override{
+        while(next==batch.size()){if(!batch.empty()&&batch.back().type==TokenType::END_OF_FILE)return batch.back();batch.clear();next=0;channel.receive(batch);}
+        return std::move(batch[next++]);
+    }
 };
+int run_pipeline(std::istream& in){
+    const std::size_t token_batch=512,stmt_batch=128,depth=64;MemoryBudget budget(memory_limit);MemoryScope scope(budget);
+    Channel<TokenBatch> tokens(depth);Channel<StmtBatch> parsed(depth),checked(depth);
+    Diagnostics syntax_errors,semantic_errors,runtime_errors;
+    Lexer lexer(in);
+    std::thread lexer_stage([&]{
+        for(bool eof=false;!eof;){TokenBatch batch;batch.reserve(token_batch);while(batch.size()<token_batch){batch.push_back(lexer.nextToken());if(batch.back().type==TokenType::END_OF_FILE){eof=true;break;}}tokens.send(batch);}
+    });
+    std::thread parser_stage([&]{
+        MemoryScope stage_scope(budget);ChannelTokenSource source(tokens);Parser parser(source,syntax_errors,int_mode);StmtBatch batch,end;std::size_t seen=0;
+        while(std::unique_ptr<Stmt> stmt=parser.parseNext()){
+            if(syntax_errors.count()!=seen){seen=syntax_errors.count();batch.push_back(nullptr);}
+            batch.push_back(std::move(stmt));if(batch.size()>=stmt_batch){parsed.send(batch);batch=StmtBatch();}
+        }
+        if(syntax_errors.count()!=seen)batch.push_back(nullptr);
+        // Parsing can stop early at the memory limit; drain the lexer so it does not block on a full channel.
+        while(source.nextToken().type!=TokenType::END_OF_FILE){}
+        if(!batch.empty())parsed.send(batch);
+        parsed.send(end);
+    });
+    std::thread analyzer_stage([&]{
+        MemoryScope stage_scope(budget);SemanticAnalyzer analyzer(semantic_errors,false);StmtBatch batch,end;
+        for(;;){
+            parsed.receive(batch);if(batch.empty())break;StmtBatch forward;forward.reserve(batch.size()+1);
+            for(auto& stmt:batch){if(!analyzer.analyzeStmt(stmt.get()))forward.push_back(nullptr);forward.push_back(std::move(stmt));}
+            checked.send(forward);
+        }
+        checked.send(end);
+    });
+    Interpreter interpreter(runtime_errors,std::cout,false,int_mode);interpreter.setLimits(max_steps,timeout);StmtBatch batch;bool running=true;
+    for(;;){checked.receive(batch);if(batch.empty())break;for(const auto& stmt:batch){if(!running)break;running=stmt&&interpreter.executeStmt(stmt.get());}}
+    lexer_stage.join();parser_stage.join();analyzer_stage.join();
+    Diagnostics diagnostics;lexer.reportTruncation(diagnostics);diagnostics.append(syntax_errors);diagnostics.append(semantic_errors);diagnostics.append(runtime_errors);
+    std::cout.flush();diagnostics.print(std::cerr,lexer.lineIndex());if(show_stats)budget.print(std::cerr);return diagnostics.hasErrors()?1:0;
+}
+int run_pipeline(const std::string& path){if(path=="-")return run_pipeline(std::cin);std::ifstream in(path,std::ios::binary);if(!in){std::cerr<<"Error: cannot read '"<<path<<"'\n";return 1;}return run_pipeline(in);}
 
-// --- Interpreter (Execution) ---
-class Interpreter{
-private:
-    std::map<std::string,int> memory; 
-    int evaluateExpr(Expr* expr){
-        if(!expr)throw std::runtime_error("Runtime Error: Null expression.");
-        if(NumberExpr* num=dynamic_cast<NumberExpr*>(expr)){return num->value;}
-        if(IdentifierExpr* id=dynamic_cast<IdentifierExpr*>(expr)){if(memory.find(id->name)==memory.end()){throw std::runtime_error("Runtime Error: Variable '"+id->name+"' used before assignment.");}return memory.at(id->name);}
-        if(IncCallExpr* inc=dynamic_cast<IncCallExpr*>(expr)){return evaluateExpr(inc->argument.get())+1;}
-        throw std::runtime_error("Runtime Error: Unknown expression type.");
-    }
-    void executeStmt(Stmt* stmt){
-        if(!stmt)return;
-        if(VarDeclStmt* decl=dynamic_cast<VarDeclStmt*>(stmt)){memory[decl->var_name]=decl->initial_value->value;} 
-        else if(PrintStmt* print=dynamic_cast<PrintStmt*>(stmt)){std::cout<<"Output: "<<evaluateExpr(print->expression.get())<<"\n";}
+// --- Batch Execution ---
+// Runs many independent scripts, given as a directory of *.inclang files or a manifest listing one path
+// per line, on the work-stealing pool. Each worker reuses its own source and output buffers between
+// programs. Every program's output is printed as one block, in input order, as soon as all earlier
+// programs have been printed.
+bool collect_batch(const std::string& target,std::vector<std::string>& scripts){
+    namespace fs=std::filesystem;std::error_code ec;
+    if(fs::is_directory(target,ec)){
+        for(const auto& entry:fs::directory_iterator(target,ec)){if(entry.is_regular_file()&&entry.path().extension()==".inclang")scripts.push_back(entry.path().string());}
+        std::sort(scripts.begin(),scripts.end());return !ec;
     }
-public:
-    void interpret(Program* program){
-        // Note on Intermediate Representation (IR): 
-        // This interpreter uses Direct AST Interpretation, skipping the optional 
-        // Three-Address Code (TAC) generation for simplicity.
-        std::cout<<"\n--- Starting Code Execution (Direct AST Interpretation) ---\n";
-        if(!program)return;for(const auto& stmt:program->statements){executeStmt(stmt.get());}std::cout<<"Execution finished successfully.\n";
+    std::ifstream manifest(target);if(!manifest)return false;fs::path base=fs::path(target).parent_path();
+    for(std::string line;std::getline(manifest,line);){
+        if(!line.empty()&&line.back()=='\r')line.pop_back();
+        if(line.empty()||line[0]=='#')continue;
+        fs::path script(line);scripts.push_back((script.is_relative()?base/script:script).string());
     }
-};
+    return true;
+}
+int run_batch(const std::string& target,std::size_t jobs){
+    std::vector<std::string> scripts;if(!collect_batch(target,scripts)){std::cerr<<"Error: cannot read batch '"<<target<<"'\n";return 1;}
+    // Each worker keeps one Engine, whose frame and output buffer are reused from program to program, and
+    // one MemoryBudget that outlives it and is restarted for every program. Step and time limits apply to
+    // each program on its own.
+    struct WorkerArena{std::string source,output;MemoryBudget budget{memory_limit};Engine engine{int_mode,backend};};
+    WorkStealingPool pool(jobs?jobs:std::max(1u,std::thread::hardware_concurrency()));std::vector<WorkerArena> arenas(pool.size());
+    for(WorkerArena& arena:arenas)configure_engine(arena.engine);
+    std::vector<std::string> results(scripts.size());std::vector<char> ready(scripts.size(),0);std::mutex print_lock;std::size_t next_to_print=0,failed=0;
+    pool.run(scripts.size(),[&](std::size_t task,std::size_t worker){
+        WorkerArena& arena=arenas[worker];arena.output="==> "+scripts[task]+" <==\n";bool ok=true;MemoryScope scope(arena.budget);arena.budget.restart();
+        if(!readFile(scripts[task],arena.source)){arena.output+="Error: cannot read '"+scripts[task]+"'\n";ok=false;}
+        else{
+            std::shared_ptr<const CompiledProgram> program=arena.engine.compile(arena.source,scripts[task]);
+            ok=arena.engine.run(*program,[&](const char* data,std::size_t size){arena.output.append(data,size);});
+            if(!ok){std::ostringstream errors;program->printErrors(errors);arena.engine.runErrors().print(errors,LineIndex::of(arena.source));arena.output+=errors.str();}
+        }
+        if(show_stats){std::ostringstream stats;arena.budget.print(stats);arena.output+=stats.str();}
+        std::lock_guard<std::mutex> guard(print_lock);results[task]=arena.output;ready[task]=1;if(!ok)failed++;
+        while(next_to_print<scripts.size()&&ready[next_to_print]){std::cout<<results[next_to_print];std::string().swap(results[next_to_print]);next_to_print++;}
+    });
+    std::cout.flush();std::cerr<<"Ran "<<scripts.size()<<" programs on "<<pool.size()<<" workers, "<<failed<<" failed.\n";
+    return failed?1:0;
+}
+
+// --- Columnar Batch Mode ---
+// '--columns <script> <table>' runs the script once for every row of a CSV table. The header names
+// the variables to bind and each row gives their values, integers from 0 to the mode's maximum. All
+// rows run together on the ColumnarVm, and the output is CSV as well: one column per print statement,
+// headed by its line:column, and one line per input row. A row that fails has empty cells from the
+// failing print on, and its error goes to 'err'.
+bool parse_cell(const std::string& cell,std::int64_t& value){auto end=cell.data()+cell.size();auto result=std::from_chars(cell.data(),end,value);return result.ec==std::errc()&&result.ptr==end&&value>=0&&value<=int_mode.max();}
+void split_csv(const std::string& line,std::vector<std::string>& cells){
+    cells.clear();
+    for(std::size_t start=0;;){
+        std::size_t comma=std::min(line.find(',',start),line.size());std::string cell=line.substr(start,comma-start);
+        std::size_t first=cell.find_first_not_of(" \t\r"),last=cell.find_last_not_of(" \t\r");cells.push_back(first==std::string::npos?"":cell.substr(first,last-first+1));
+        if(comma==line.size()){break;}start=comma+1;
+    }
+}
+int run_columns(const std::string& source,std::istream& table,std::ostream& out,std::ostream& err){
+    if(int_mode.width==IntWidth::Big){err<<"Error: '--columns' runs on the VM, which does not support '--bigint'\n";return 1;}
+    std::string line;std::vector<std::string> names,cells;
+    if(!std::getline(table,line)){err<<"Error: the table has no header\n";return 1;}
+    split_csv(line,names);
+    for(std::size_t i=0;i<names.size();i++){
+        Lexer lexer(names[i]);Token name=lexer.nextToken();
+        if(name.type!=TokenType::IDENTIFIER||lexer.nextToken().type!=TokenType::END_OF_FILE){err<<"Error: column '"<<names[i]<<"' is not a variable name\n";return 1;}
+        if(std::find(names.begin(),names.begin()+static_cast<std::ptrdiff_t>(i),names[i])!=names.begin()+static_cast<std::ptrdiff_t>(i)){err<<"Error: column '"<<names[i]<<"' appears twice\n";return 1;}
+    }
+    std::vector<std::vector<std::int64_t>> inputs(names.size());std::size_t rows=0;
+    while(std::getline(table,line)){
+        if(line.find_first_not_of(" \t\r")==std::string::npos)continue;
+        rows++;split_csv(line,cells);
+        if(cells.size()!=names.size()){err<<"Error: row "<<rows<<" has "<<cells.size()<<" values for "<<names.size()<<" columns\n";return 1;}
+        for(std::size_t i=0;i<cells.size();i++){
+            std::int64_t value;if(!parse_cell(cells[i],value)){err<<"Error: row "<<rows<<", column '"<<names[i]<<"': '"<<cells[i]<<"' is not an integer from 0 to "<<int_mode.max()<<"\n";return 1;}
+            inputs[i].push_back(value);
+        }
+    }
+    // The bound variables are declared before the script, so they take the first slots.
+    Diagnostics diagnostics;SemanticAnalyzer analyzer(diagnostics,false);for(const std::string& name:names)analyzer.declare(name);
+    Lexer lexer(source);Parser parser(lexer,diagnostics,int_mode);std::unique_ptr<Program> ast=parser.parse();analyzer.analyze(ast.get());Bytecode bytecode;
+    if(diagnostics.hasErrors()){diagnostics.print(err,lexer.lineIndex());return 1;}
+    if(!bytecode.compile(*ast,analyzer.slotCount(),int_mode)){err<<"Error: '--columns' runs on the VM, which does not support repeat loops or arrays\n";return 1;}
+    std::string text;
+    for(const Instruction& ins:bytecode.code){
+        if(ins.op!=OpCode::PRINT&&ins.op!=OpCode::PRINTI)continue;
+        SourceLocation loc=lexer.lineIndex().locate(ins.offset);if(!text.empty())text+=',';text+=std::to_string(loc.line)+":"+std::to_string(loc.column);
+    }
+    out<<text<<"\n";text.clear();
+    ColumnarVm vm(diagnostics,int_mode);char digits[24];
+    bool ok=vm.run(bytecode,inputs,rows,[&](const ColumnBlock& block){
+        for(std::size_t i=0;i<block.rows;i++){
+            for(std::size_t p=0;p<block.prints.size();p++){if(p){text+=',';}if(p<block.printed[i])text.append(digits,std::to_chars(digits,digits+sizeof(digits),block.prints[p][i]).ptr);}
+            text+='\n';
+        }
+        out.write(text.data(),static_cast<std::streamsize>(text.size()));text.clear();
+    });
+    out.flush();if(!ok){diagnostics.print(err,lexer.lineIndex());return 1;}
+    return 0;
+}
+int run_columns(const std::string& script,const std::string& table_path){
+    std::string source;if(!readFile(script,source)){std::cerr<<"Error: cannot read '"<<script<<"'\n";return 1;}
+    std::ifstream table(table_path,std::ios::binary);if(!table){std::cerr<<"Error: cannot read '"<<table_path<<"'\n";return 1;}
+    std::ios::sync_with_stdio(false);return run_columns(source,table,std::cout,std::cerr);
+}
+
+// --- Interactive REPL ---
+// Keeps one SemanticAnalyzer and one Interpreter alive for the whole session, so declarations and values
+// carry over between inputs; each input is lexed and parsed on its own and runs as soon as it is
+// complete. Input without a trailing ';' or '}', or inside an open repeat body, continues on the next line. A statement with errors does not
+// run, and neither do the statements after it in the same input; names it declared are forgotten, so
+// rejected input declares nothing. ':vars' lists the current values, ':reset' clears all state and
+// ':quit' exits.
+bool stdin_is_terminal(){
+#if defined(_WIN32)
+    return _isatty(_fileno(stdin))!=0;
+#else
+    return isatty(fileno(stdin))!=0;
+#endif
+}
+int run_repl(std::istream& in,std::ostream& out,std::ostream& err,bool interactive){
+    MemoryBudget budget(memory_limit);MemoryScope scope(budget);Diagnostics diagnostics;
+    auto analyzer=std::make_unique<SemanticAnalyzer>(diagnostics,false);auto interpreter=std::make_unique<Interpreter>(diagnostics,out,false,int_mode);
+    std::string pending;
+    for(std::string line;;){
+        if(interactive){out<<(pending.empty()?"inc> ":"...> ")<<std::flush;}
+        if(!std::getline(in,line)){if(pending.empty())break;line.clear();}
+        else{
+            if(pending.empty()&&line==":quit")break;
+            if(pending.empty()&&line==":reset"){analyzer=std::make_unique<SemanticAnalyzer>(diagnostics,false);interpreter=std::make_unique<Interpreter>(diagnostics,out,false,int_mode);continue;}
+            if(pending.empty()&&line==":vars"){std::string value;for(const auto& var:analyzer->symbols()){if(interpreter->valueText(var.second,value))out<<var.first<<" = "<<value<<"\n";}out<<std::flush;continue;}
+            pending+=line;pending+='\n';std::size_t last=pending.find_last_not_of(" \t\r\n");
+            if(last==std::string::npos){pending.clear();continue;}
+            if((pending[last]!=';'&&pending[last]!='}')||std::count(pending.begin(),pending.end(),'{')>std::count(pending.begin(),pending.end(),'}'))continue;
+        }
+        diagnostics.clear();budget.restart();interpreter->setLimits(max_steps,timeout);Lexer lexer(pending);Parser parser(lexer,diagnostics,int_mode);std::unique_ptr<Program> input=parser.parse();
+        if(!diagnostics.hasErrors()){for(const auto& stmt:input->statements){if(!analyzer->analyzeStmt(stmt.get())){analyzer->forgetLast();break;}if(!interpreter->executeStmt(stmt.get()))break;}}
+        out.flush();diagnostics.print(err,lexer.lineIndex());if(show_stats)budget.print(err);pending.clear();
+        if(!in)break;
+    }
+    return 0;
+}
 
 // --- Main Execution and Tests ---
 void run_test(const std::string& name,const std::string& code){
     std::cout<<"\n==========================================\nTEST: "<<name<<"\n==========================================\nSource Code:\n"<<code<<"\n";
-    try{
-        Lexer lexer(code);Parser parser(lexer);std::unique_ptr<Program> ast=parser.parse();
-        SemanticAnalyzer analyzer;analyzer.analyze(ast.get());
-        Interpreter interpreter;interpreter.interpret(ast.get());
-    }catch(const std::exception& e){std::cerr<<"\n[Caught Expected Error] "<<e.what()<<std::endl;}
+    Diagnostics diagnostics;
+    Lexer lexer(code);Parser parser(lexer,diagnostics);std::unique_ptr<Program> ast=parser.parse();
+    SemanticAnalyzer analyzer(diagnostics);analyzer.analyze(ast.get());
+    if(!diagnostics.hasErrors()){Interpreter interpreter(diagnostics);interpreter.interpret(ast.get());}
+    diagnostics.print(std::cerr,lexer.lineIndex(),"\n[Caught Expected Error] ");
+}
+
+// Checks print "same" or "MISMATCH" for each comparison; any mismatch makes main exit nonzero.
+int mismatches=0;
+void report(const std::string& what,bool same,const std::string& compared){if(!same)mismatches++;std::cout<<what<<": "<<(same?"same ":"MISMATCH in ")<<compared<<"\n";}
+void print_check_header(const std::string& name){std::cout<<"\n==========================================\nCHECK: "<<name<<"\n==========================================\n";}
+// A producer thread pushes 0..count-1 through a small SpscQueue, alternating single and batch pushes,
+// while this thread pops with the other variant; every value must arrive exactly once and in order.
+void run_spsc_check(){
+    print_check_header("SPSC Queue (capacity 8, 200000 values)");
+    const std::size_t count=200000;SpscQueue<std::size_t> queue(8);
+    std::thread producer([&]{std::size_t batch[5];for(std::size_t next=0;next<count;){
+        if(next%2){std::size_t n=std::min<std::size_t>(5,count-next);for(std::size_t i=0;i<n;i++)batch[i]=next+i;std::size_t pushed=0;while(pushed<n){std::size_t moved=queue.tryPushBatch(batch+pushed,n-pushed);if(!moved)std::this_thread::yield();pushed+=moved;}next+=n;}
+        else{std::size_t item=next;while(!queue.tryPush(item))std::this_thread::yield();next++;}}});
+    std::vector<std::size_t> received;received.reserve(count);std::size_t batch[3];
+    while(received.size()<count){if(received.size()%2){std::size_t n=queue.tryPopBatch(batch,3);if(!n)std::this_thread::yield();received.insert(received.end(),batch,batch+n);}else{std::size_t item;if(queue.tryPop(item))received.push_back(item);else std::this_thread::yield();}}
+    producer.join();
+    bool ordered=true;for(std::size_t i=0;i<count;i++)ordered=ordered&&received[i]==i;
+    report("Single and batch transfers",ordered,"order");
+}
+
+// Runs uneven task sets on one pool twice: the first worker's share is slow so the others have to steal
+// it. Every task must run exactly once per round.
+void run_pool_check(){
+    print_check_header("Work-Stealing Pool (4 workers, 1000 uneven tasks, 2 rounds)");
+    WorkStealingPool pool(4);const std::size_t count=1000;
+    for(int round=1;round<=2;round++){
+        std::vector<std::atomic<int>> runs(count);
+        pool.run(count,[&](std::size_t task,std::size_t){if(task<count/4)std::this_thread::sleep_for(std::chrono::microseconds(200));runs[task]++;});
+        bool once=std::all_of(runs.begin(),runs.end(),[](const std::atomic<int>& n){return n==1;});
+        report("Round "+std::to_string(round),once,"run count of every task (1)");
+    }
+}
+
+// Feeds a session to the REPL: a rejected statement stops its input without undoing the ones before it,
+// and later inputs still see them.
+void run_repl_check(){
+    print_check_header("REPL Session");
+    std::istringstream in("a=1;print(inc(b));a=7;\nprint(inc(a));\n:vars\n");std::ostringstream out,err;run_repl(in,out,err,false);
+    report("Output and :vars",out.str()=="Output: 2\na = 1\n","text");
+    report("Diagnostics",err.str()=="Semantic Error: Variable 'b' is undeclared at line 1, column 15\n","text");
 }
 
-int main(){
+// Edits a Document and compares its diagnostics after each edit with a full compile of the same text;
+// each edit must reparse only the statements around it.
+std::string compile_errors(const std::string& code){std::ostringstream errors;Engine().compile(code)->printErrors(errors);return errors.str();}
+std::string document_errors(const Document& document){Diagnostics diagnostics;document.diagnostics(diagnostics);std::ostringstream errors;diagnostics.print(errors,LineIndex::of(document.text()));return errors.str();}
+void run_document_check(){
+    print_check_header("Incremental Document (4000 statements, 3 edits)");
+    std::string code;for(int i=0;i<2000;i++){code+="v"+std::to_string(i)+"="+std::to_string(i)+";print(inc(v"+std::to_string(i)+"));\n";}
+    std::uint32_t middle=static_cast<std::uint32_t>(code.find('\n',code.size()/2)+1);code.insert(middle,"print(inc(u));\n");
+    Document document(code);report("Fresh",document_errors(document)==compile_errors(code),"diagnostics");
+    struct Edit{const char* name;std::uint32_t offset,removed;std::string inserted;};
+    for(const Edit& edit:{Edit{"Declare u before its use",middle,0,"u=5;"},Edit{"Split a statement",middle+4,0,";q=1;"},Edit{"Undo both",middle,9,""}}){
+        document.applyEdit(edit.offset,edit.removed,edit.inserted);
+        report(std::string(edit.name)+" ("+std::to_string(document.lastReparseCount())+" statements reparsed)",document_errors(document)==compile_errors(document.text())&&document.lastReparseCount()<=4,"diagnostics");
+    }
+    report("Text after undo",document.text()==code,"source");
+}
+
+// Drives a language server session over string streams: hovers before and after an edit must show the
+// value the reaching declaration assigned, and the value a later assignment carries into the next pass
+// of a loop; an undeclared name must be reported as such. A message over the size cap must be rejected
+// without ending the session, and a '--bigint' session must accept and show a literal past 64 bits.
+std::string lsp_frame(const std::string& body){return "Content-Length: "+std::to_string(body.size())+"\r\n\r\n"+body;}
+std::string lsp_hover(int id,int line,int character){return lsp_frame("{\"jsonrpc\":\"2.0\",\"id\":"+std::to_string(id)+",\"method\":\"textDocument/hover\",\"params\":{\"textDocument\":{\"uri\":\"file:///a.inc\"},\"position\":{\"line\":"+std::to_string(line)+",\"character\":"+std::to_string(character)+"}}}");}
+void run_lsp_check(){
+    print_check_header("Language Server Hover");
+    std::string session=lsp_frame(R"({"jsonrpc":"2.0","id":1,"method":"initialize","params":{}})")
+        +lsp_frame(R"({"jsonrpc":"2.0","method":"textDocument/didOpen","params":{"textDocument":{"uri":"file:///a.inc","text":"x=1;\nprint(x);\nx=5;\nprint(inc(x));\nprint(y);\nrepeat 2{\n  print(x);\n  repeat 3{print(inc(x));x=9;}\n}\n"}}})")
+        +lsp_hover(2,1,6)+lsp_hover(3,3,10)+lsp_hover(4,4,6)+lsp_hover(7,6,8)+lsp_hover(8,7,21)
+        +lsp_frame(R"({"jsonrpc":"2.0","method":"textDocument/didChange","params":{"textDocument":{"uri":"file:///a.inc"},"contentChanges":[{"range":{"start":{"line":2,"character":2},"end":{"line":2,"character":3}},"text":"7"}]}})")
+        +lsp_hover(5,3,10)+lsp_frame(R"({"jsonrpc":"2.0","id":6,"method":"shutdown"})")+lsp_frame(R"({"jsonrpc":"2.0","method":"exit"})");
+    std::istringstream in(session);std::ostringstream out;int status=run_lsp(in,out);std::string replies=out.str();
+    auto hover_is=[&](int id,const std::string& value){return replies.find("\"id\":"+std::to_string(id)+",\"result\":{\"contents\":{\"kind\":\"plaintext\",\"value\":\""+value+"\"}")!=std::string::npos;};
+    report("Hover after the first declaration",hover_is(2,"x = 1 (declared at line 1)"),"text");
+    report("Hover after the redeclaration",hover_is(3,"x = 5 (declared at line 3)"),"text");
+    report("Hover on an undeclared name",hover_is(4,"y: undeclared"),"text");
+    report("Hover after an edit",hover_is(5,"x = 7 (declared at line 3)"),"text");
+    report("Hover in a repeat body",hover_is(7,"x = 5 (declared at line 3); 9 on later passes (assigned at line 8)"),"text");
+    report("Hover in a nested repeat body",hover_is(8,"x = 5 (declared at line 3); 9 on later passes (assigned at line 8)"),"text");
+    report("Exit status after shutdown",status==0,"value");
+    std::string oversized="Content-Length: "+std::to_string((64<<20)+1)+"\r\n\r\n"+std::string((64<<20)+1,' ')+lsp_frame(R"({"jsonrpc":"2.0","id":1,"method":"shutdown"})")+lsp_frame(R"({"jsonrpc":"2.0","method":"exit"})");
+    std::istringstream oversized_in(oversized);std::ostringstream oversized_out;status=run_lsp(oversized_in,oversized_out);
+    report("Message over 64 MiB",oversized_out.str().find("\"code\":-32700")!=std::string::npos&&status==0,"error reply and exit status");
+    std::string big=lsp_frame(R"({"jsonrpc":"2.0","id":1,"method":"initialize","params":{}})")
+        +lsp_frame(R"({"jsonrpc":"2.0","method":"textDocument/didOpen","params":{"textDocument":{"uri":"file:///a.inc","text":"x=123456789012345678901234567890;\nprint(inc(x));\n"}}})")
+        +lsp_hover(2,1,10)+lsp_frame(R"({"jsonrpc":"2.0","id":3,"method":"shutdown"})")+lsp_frame(R"({"jsonrpc":"2.0","method":"exit"})");
+    std::istringstream big_in(big);std::ostringstream big_out;run_lsp(big_in,big_out,IntMode{IntWidth::Big,Overflow::Trap});replies=big_out.str();
+    report("Document in '--bigint' mode",replies.find("\"diagnostics\":[]")!=std::string::npos&&hover_is(2,"x = 123456789012345678901234567890 (declared at line 1)"),"diagnostics and hover text");
+}
+
+// Lexes integer literals of every length from 1 to 25 digits, in memory and from a stream where they
+// straddle 4096-byte refills, and compares their values and overflow flags with std::stoull.
+void run_literal_check(){
+    print_check_header("Integer Literals (2000 literals, 1 to 25 digits)");
+    std::mt19937_64 random(38);std::vector<std::string> literals{"0","00000000","12345678","123456789","18446744073709551615","18446744073709551616","000000000000000000000018446744073709551615","99999999999999999999"};
+    while(literals.size()<2000){std::string digits;std::size_t length=1+random()%25;for(std::size_t i=0;i<length;i++)digits+=static_cast<char>('0'+random()%10);literals.push_back(digits);}
+    std::string code;for(const std::string& literal:literals){code+=literal;code.append(1+random()%7,' ');}
+    auto matches=[&](TokenSource& lexer){
+        for(const std::string& literal:literals){
+            Token t=lexer.nextToken();std::uint64_t expected=0;bool overflowed=false;
+            try{expected=std::stoull(literal);}catch(const std::out_of_range&){overflowed=true;}
+            if(t.type!=TokenType::NUMBER||t.lexeme!=literal||t.overflowed!=overflowed||(!overflowed&&t.value!=expected))return false;
+        }
+        return lexer.nextToken().type==TokenType::END_OF_FILE;
+    };
+    Lexer in_memory(code);report("In memory",matches(in_memory),"values and overflow flags");
+    std::istringstream input(code);Lexer streamed(input);report("Streamed",matches(streamed),"values and overflow flags");
+}
+
+// Runs the same program on the other backends; each must match the AST interpreter's output and
+// diagnostics exactly. 'shown' stands in for generated sources.
+struct Outcome{std::string output,compile_errors,run_errors;bool operator==(const Outcome& other)const{return output==other.output&&compile_errors==other.compile_errors&&run_errors==other.run_errors;}};
+Outcome run_on(const std::string& code,Backend backend,bool from_parser=false){
+    Engine engine(IntMode(),backend);engine.setHotThreshold(1);engine.setSinglePass(from_parser);std::shared_ptr<const CompiledProgram> program=engine.compile(code);
+    Outcome outcome;std::ostringstream compile_errors,run_errors;program->printErrors(compile_errors);
+    if(program->ok()&&!engine.run(*program,[&](const char* data,std::size_t size){outcome.output.append(data,size);}))engine.runErrors().print(run_errors,LineIndex::of(code));
+    outcome.compile_errors=compile_errors.str();outcome.run_errors=run_errors.str();return outcome;
+}
+// Compiles 'code' on a single-pass Vm engine and runs it twice on an engine for 'backend', which
+// shares the program; the second run is the one a Tiered engine promotes.
+Outcome run_shared(const std::string& code,Backend backend){
+    Engine compiler(IntMode(),Backend::Vm);compiler.setSinglePass(true);std::shared_ptr<const CompiledProgram> program=compiler.compile(code);
+    Engine engine(IntMode(),backend);engine.setHotThreshold(2);Outcome outcome;std::ostringstream compile_errors,run_errors;program->printErrors(compile_errors);
+    for(int run=0;run<2&&program->ok();run++){
+        outcome.output.clear();run_errors.str("");
+        if(!engine.run(*program,[&](const char* data,std::size_t size){outcome.output.append(data,size);}))engine.runErrors().print(run_errors,LineIndex::of(code));
+    }
+    outcome.compile_errors=compile_errors.str();outcome.run_errors=run_errors.str();return outcome;
+}
+void run_backend_check(const std::string& name,const std::string& code,const std::string& shown){
+    print_check_header(name);std::cout<<"Source Code:\n"<<shown<<"\n";
+    Outcome expected=run_on(code,Backend::Ast);
+    std::cout<<"AST Interpreter: "<<std::count(expected.output.begin(),expected.output.end(),'\n')<<" output lines\n"<<expected.compile_errors<<expected.run_errors;
+    report("Register VM",run_on(code,Backend::Vm)==expected,"output and diagnostics");
+    report("Native Code",run_on(code,Backend::Tiered)==expected,"output and diagnostics");
+    report("Single-Pass VM",run_on(code,Backend::Vm,true)==expected,"output and diagnostics");
+    report("Single-Pass on AST Engine",run_shared(code,Backend::Ast)==expected,"output and diagnostics");
+    report("Single-Pass on Tiered Engine",run_shared(code,Backend::Tiered)==expected,"output and diagnostics");
+}
+
+// Runs generated programs sequentially and on a 4-worker pool: the parallel run must print the same
+// output and diagnostics and leave every variable with the same value. The trapping program overflows
+// in the middle of a chunk, and the '--bigint' one carries values past 64 bits across chunks.
+std::string run_interpreter(const std::string& code,IntMode mode,WorkStealingPool* pool,std::uint64_t max_steps=0){
+    Diagnostics diagnostics;std::ostringstream out;Lexer lexer(code);Parser parser(lexer,diagnostics,mode);std::unique_ptr<Program> ast=parser.parse();
+    SemanticAnalyzer analyzer(diagnostics,false);analyzer.analyze(ast.get());Interpreter interpreter(diagnostics,out,false,mode);interpreter.reset(analyzer.slotCount());interpreter.setLimits(max_steps,std::chrono::milliseconds(0));
+    if(!diagnostics.hasErrors()&&(pool?interpreter.interpretParallel(ast.get(),*pool):interpreter.interpret(ast.get()))){
+        std::string value;for(const auto& var:analyzer.symbols()){if(interpreter.valueText(var.second,value))out<<var.first<<" = "<<value<<"\n";}
+    }
+    diagnostics.print(out,lexer.lineIndex());return out.str();
+}
+void run_parallel_check(){
+    print_check_header("Parallel Interpreter (4 workers, 3 programs of 60000 statements)");
+    WorkStealingPool pool(4);std::mt19937 random(45);
+    auto generate=[&](std::size_t statements,std::size_t overflow_at,const std::string& big){
+        std::string code;for(int v=0;v<40;v++)code+="v"+std::to_string(v)+"="+std::to_string(v)+";";
+        for(std::size_t i=0;i<statements;i++){
+            std::string var="v"+std::to_string(random()%40);
+            if(i==overflow_at){code+=var+"=2147483647;print(inc("+var+"));";continue;}
+            if(random()%4==0){code+=var+"="+(big.empty()?std::to_string(random()%1000):big)+";";continue;}
+            int depth=static_cast<int>(random()%3);code+="print(";for(int d=0;d<depth;d++)code+="inc(";code+=var+std::string(static_cast<std::size_t>(depth),')')+");";
+        }
+        return code;
+    };
+    struct Case{const char* name;std::string code;IntMode mode;};
+    for(const Case& c:{Case{"Straight-line",generate(60000,SIZE_MAX,""),IntMode()},Case{"Overflow trap",generate(60000,37777,""),IntMode()},Case{"Big values",generate(60000,SIZE_MAX,"18446744073709551615"),IntMode{IntWidth::Big,Overflow::Trap}}}){
+        report(c.name,run_interpreter(c.code,c.mode,&pool)==run_interpreter(c.code,c.mode,nullptr),"output, diagnostics and final values");
+    }
+}
+
+// Analyzes generated programs sequentially and on a 4-worker pool: diagnostics (beyond the 100 kept),
+// slot numbers and the slot of every declaration and use must be identical. Names are declared for
+// the first time in every chunk and used both before and after that.
+std::string analysis_summary(const std::string& code,WorkStealingPool* pool){
+    Diagnostics diagnostics;Lexer lexer(code);Parser parser(lexer,diagnostics);std::unique_ptr<Program> ast=parser.parse();SemanticAnalyzer analyzer(diagnostics,false);
+    bool ok=pool?analyzer.analyzeParallel(ast.get(),*pool):analyzer.analyze(ast.get());
+    std::ostringstream summary;summary<<ok<<"\n";diagnostics.print(summary,lexer.lineIndex());
+    for(const auto& var:analyzer.symbols())summary<<var.first<<":"<<var.second<<" ";
+    for(const auto& stmt:ast->statements){
+        if(const VarDeclStmt* decl=dynamic_cast<const VarDeclStmt*>(stmt.get())){summary<<decl->slot<<" ";continue;}
+        const Expr* expr=static_cast<const PrintStmt*>(stmt.get())->expression.get();
+        while(const IncCallExpr* inc=dynamic_cast<const IncCallExpr*>(expr))expr=inc->argument.get();
+        if(const IdentifierExpr* id=dynamic_cast<const IdentifierExpr*>(expr))summary<<id->slot<<" ";
+    }
+    return summary.str();
+}
+void run_analysis_check(){
+    print_check_header("Parallel Analysis (4 workers, 40000 statements)");
+    WorkStealingPool pool(4);std::mt19937 random(46);
+    std::string declared,undeclared;
+    for(int i=0;i<40000;i++){
+        std::string var="n"+std::to_string(random()%(1+i/40));
+        if(random()%3==0){declared+=var+"="+std::to_string(i)+";";undeclared+=var+"="+std::to_string(i)+";";}
+        else{declared+="print(inc("+std::string(i<5000?"n0":var)+"));";undeclared+="print(inc("+var+"));";}
+    }
+    declared="n0=1;"+declared;
+    report("Declared before use",analysis_summary(declared,&pool)==analysis_summary(declared,nullptr),"diagnostics and slots");
+    report("Undeclared uses",analysis_summary(undeclared,&pool)==analysis_summary(undeclared,nullptr),"diagnostics and slots");
+}
+
+// Runs repeat loops against their textual unrolling (output and final values; error locations differ),
+// the shortcut that replays the second pass against the step-limited run that executes every pass, the
+// parallel interpreter against the sequential one, and Document diagnostics against a full compile.
+std::string without_locations(std::string text){for(std::size_t at;(at=text.find(" at line "))!=std::string::npos;)text.erase(at,text.find('\n',at)-at);return text;}
+std::string unrolled(std::uint64_t count,const std::string& body){std::string code;for(std::uint64_t i=0;i<count;i++)code+=body;return code;}
+void run_repeat_check(){
+    print_check_header("Repeat Loops");
+    struct Case{const char* name;std::string code,expanded;};
+    const std::string inner="print(inc(y));y=7;";
+    for(const Case& c:{Case{"Read before write","x=1;repeat 3{print(x);x=5;}print(x);","x=1;"+unrolled(3,"print(x);x=5;")+"print(x);"},
+                       Case{"Nested loops","y=1;repeat 4{print(y);repeat 3{"+inner+"}y=2;}","y=1;"+unrolled(4,"print(y);"+unrolled(3,inner)+"y=2;")},
+                       Case{"Passes longer than the replay buffer","x=1;repeat 4{repeat 9000{print(inc(x));}x=2;}","x=1;"+unrolled(4,unrolled(9000,"print(inc(x));")+"x=2;")},
+                       Case{"Overflow in the second pass","w=2147483646;repeat 5{print(inc(w));w=2147483647;}","w=2147483646;"+unrolled(5,"print(inc(w));w=2147483647;")}}){
+        report(c.name,without_locations(run_interpreter(c.code,IntMode(),nullptr))==without_locations(run_interpreter(c.expanded,IntMode(),nullptr)),"output and final values");
+    }
+    const std::string empty_loops="repeat 10000000000{}print(1);repeat 10000000000{repeat 3{}repeat 0{}}print(2);";
+    report("Empty loops under a step limit",run_interpreter(empty_loops,IntMode(),nullptr,5)==run_interpreter(empty_loops,IntMode(),nullptr),"output and final values");
+    report("Repeat 0",without_locations(run_interpreter("repeat 0{z=1;}print(1);print(z);",IntMode(),nullptr))=="Output: 1\nRuntime Error: Variable 'z' used before assignment\n","output and diagnostics");
+    std::string code="a=1;b=2;";std::mt19937 random(48);
+    for(int i=0;i<300;i++){
+        std::string var=random()%2?"a":"b";
+        switch(random()%4){
+            case 0:code+=var+"="+std::to_string(random()%100)+";";break;
+            case 1:code+="print(inc("+var+"));";break;
+            case 2:code+="repeat "+std::to_string(random()%300)+"{print("+var+");"+var+"="+std::to_string(random()%100)+";repeat "+std::to_string(random()%3)+"{print(inc(a));b=1;}}";break;
+            default:code+="repeat 1{print(b);}";break;
+        }
+    }
+    report("Replayed and executed passes",run_interpreter(code,IntMode(),nullptr)==run_interpreter(code,IntMode(),nullptr,UINT64_MAX),"output and final values");
+    std::string parallel;for(int i=0;i<20;i++)parallel+=code;
+    WorkStealingPool pool(4);report("Parallel Interpreter",run_interpreter(parallel,IntMode(),&pool)==run_interpreter(parallel,IntMode(),nullptr),"output, diagnostics and final values");
+    std::string document_code="x=1;\nrepeat 2{\n  print(x);\n  y=x;\n  print(y);q=3;\n}\nrepeat 3{print(q);print(z);\n  z=4;\n}\nrepeat 2{print(w);print(inc(c));print(w);}\n";
+    Document document(document_code);report("Document",document_errors(document)==compile_errors(document_code),"diagnostics");
+    document.applyEdit(static_cast<std::uint32_t>(document_code.find("y=x;")),4,"y=2;");
+    report("Document after an edit",document_errors(document)==compile_errors(document.text()),"diagnostics");
+}
+
+// Compares inc_elements() on every instruction set this CPU has with single inc() steps applied to each
+// element, in all fixed widths and policies, over lengths that leave every vector tail; then runs a
+// program with arrays and checks its output and that the parallel interpreter and Document agree.
+void run_array_check(){
+    print_check_header("Array Kernels ("+std::string(isa_name(best_isa()))+")");
+    std::mt19937_64 random(49);
+    for(int isa=0;isa<=static_cast<int>(best_isa());isa++){
+        bool same=true;
+        for(IntWidth width:{IntWidth::Int32,IntWidth::Int64})for(Overflow overflow:{Overflow::Trap,Overflow::Wrap,Overflow::Saturate}){
+            IntMode mode{width,overflow};
+            for(std::size_t n=0;n<40;n++)for(std::int64_t count=1;count<=4;count++){
+                std::vector<std::int64_t> in(n),out(n),expected(n);std::size_t first_failure=n;
+                for(std::size_t i=0;i<n;i++)in[i]=random()%3?static_cast<std::int64_t>(random()%1000):mode.max()-static_cast<std::int64_t>(random()%6);
+                if(overflow==Overflow::Trap&&random()%2){for(std::int64_t& v:in)v=std::min<std::int64_t>(v,mode.max()-count);}
+                for(std::size_t i=0;i<n;i++){
+                    std::int64_t v=in[i];
+                    for(std::int64_t step=0;step<count;step++){if(v<mode.max()){v++;}else if(overflow==Overflow::Wrap){v=mode.min();}else if(overflow==Overflow::Trap){first_failure=std::min(first_failure,i);}}
+                    expected[i]=v;
+                }
+                std::size_t failed=inc_elements(in.data(),out.data(),n,count,mode,static_cast<Isa>(isa));
+                same=same&&failed==first_failure&&(first_failure<n||out==expected);
+            }
+        }
+        report(isa_name(static_cast<Isa>(isa)),same,"results and first overflowing element");
+    }
+    std::string code="a=[6];a[2]=7;a[5]=2147483645;print(a);print(inc(a[2]));print(inc(inc(a)));b=[0];print(inc(b));\nrepeat 2{a[0]=1;print(inc(a));}a=3;print(a[0]);";
+    report("Program",run_interpreter(code,IntMode(),nullptr)=="Output: [0, 0, 7, 0, 0, 2147483645]\nOutput: 8\nOutput: [2, 2, 9, 2, 2, 2147483647]\nOutput: []\n"
+        "Output: [2, 1, 8, 1, 1, 2147483646]\nOutput: [2, 1, 8, 1, 1, 2147483646]\nRuntime Error: Variable 'a' is not an array at line 2, column 42\n","output and diagnostics");
+    std::string parallel;for(int i=0;i<2000;i++)parallel+="v=[3];v["+std::to_string(i%3)+"]="+std::to_string(i)+";print(inc(v));";
+    WorkStealingPool pool(4);report("Parallel Interpreter",run_interpreter(parallel,IntMode(),&pool)==run_interpreter(parallel,IntMode(),nullptr),"output, diagnostics and final values");
+    std::string document_code="a[0]=1;\na=[2];\na[1]=5;\nprint(inc(a[1]));print(b[0]);\n";
+    Document document(document_code);report("Document",document_errors(document)==compile_errors(document_code),"diagnostics");
+}
+
+// Runs a generated script over 3000 rows with '--columns', and every row on its own on the VM with its
+// values assigned in front of the script. Each row's cells must be that run's outputs, and the same
+// rows must fail, under trap and wrap. Rows near the maximum make some of the inc chains overflow.
+void run_columns_check(){
+    print_check_header("Columnar Batch Mode (3000 rows)");
+    std::mt19937 random(50);std::string script="z=5;";
+    for(int i=0;i<60;i++){
+        std::string var(1,"xyz"[random()%3]);
+        if(random()%5==0){script+=var+"="+std::to_string(random()%1000)+";";continue;}
+        std::size_t depth=random()%4;script+="print(";for(std::size_t d=0;d<depth;d++)script+="inc(";script+=(random()%6?var:std::to_string(random()%1000))+std::string(depth,')')+");\n";
+    }
+    std::string table="x, y\n";std::vector<std::string> prefixes;
+    for(int row=0;row<3000;row++){
+        std::string x=std::to_string(random()%50?random()%1000:2147483647-random()%3),y=std::to_string(random()%1000);
+        table+=x+","+y+"\n";prefixes.push_back("x="+x+";y="+y+";");
+    }
+    IntMode saved=int_mode;
+    for(Overflow overflow:{Overflow::Trap,Overflow::Wrap}){
+        int_mode=IntMode{IntWidth::Int32,overflow};std::istringstream in(table);std::ostringstream out,err;int status=run_columns(script,in,out,err);
+        std::string expected;std::size_t failures=0,prints=0;
+        for(const std::string& prefix:prefixes){
+            Engine engine(int_mode,Backend::Vm);std::string output;bool ok=engine.run(*engine.compile(prefix+script),[&](const char* data,std::size_t size){output.append(data,size);});
+            std::vector<std::string> values;std::istringstream lines(output);for(std::string line;std::getline(lines,line);)values.push_back(line.substr(8));
+            if(ok)prints=values.size();else failures++;
+            values.resize(std::max(prints,values.size()));for(std::size_t i=0;i<values.size();i++)expected+=(i?",":"")+values[i];expected+="\n";
+        }
+        std::string body=out.str();body.erase(0,body.find('\n')+1);
+        std::string errors=err.str();std::size_t reported=static_cast<std::size_t>(std::count(errors.begin(),errors.end(),'\n'));
+        report(overflow==Overflow::Trap?"Trap ("+std::to_string(failures)+" rows fail)":"Wrap",body==expected&&reported==failures&&status==(failures?1:0),"cells and failing rows");
+    }
+    int_mode=saved;
+    std::istringstream bad("x,y\n1,2,3\n");std::ostringstream out,err;run_columns(script,bad,out,err);
+    report("Malformed row",err.str()=="Error: row 1 has 3 values for 2 columns\n","diagnostics");
+}
+
+int main(int argc,char** argv){
+    std::vector<std::string> all(argv+1,argv+argc),args;
+    for(std::size_t i=0;i<all.size();){int used=parse_global_option(all,i);if(used<0){std::cerr<<"Error: invalid value for '"<<all[i]<<"'\n";return 1;}if(used==0)args.push_back(all[i++]);else i+=used;}
+    if(args.size()==2&&args[0]=="--precompute"){return run_precomputed(args[1]);}
+    if(args.size()==2&&args[0]=="--stream"){return run_stream(args[1]);}
+    if(args.size()==1&&args[0]=="--repl"){return run_repl(std::cin,std::cout,std::cerr,stdin_is_terminal());}
+    if(args.size()==1&&args[0]=="--lsp"){std::ios::sync_with_stdio(false);return run_lsp(std::cin,std::cout,int_mode);}
+    if(args.size()==2&&args[0]=="--pipeline"){return run_pipeline(args[1]);}
+    if(args.size()==3&&args[0]=="--columns"){return run_columns(args[1],args[2]);}
+    if((args.size()==2||(args.size()==4&&args[2]=="--jobs"))&&args[0]=="--batch"){
+        std::size_t jobs=0;
+        if(args.size()==4&&(args[3].empty()||args[3].size()>9||args[3].find_first_not_of("0123456789")!=std::string::npos||(jobs=std::stoul(args[3]))==0)){std::cerr<<"Error: invalid value for '--jobs'\n";return 1;}
+        return run_batch(args[1],jobs);
+    }
+
     std::string valid_code=R"(x=10;print(inc(x));print(inc(15));)";
     run_test("VALID Program (Expected: 11, 16)", valid_code);
 
@@ -126,6 +691,38 @@ int main(){
 
     std::string invalid_syntax_code=R"(print(inc());)";
     run_test("INVALID Program (Syntax Error)", invalid_syntax_code);
+
+    std::string multiple_errors_code=R"(x=;print(inc(y));z=1;print(inc(z)))";
+    run_test("INVALID Program (All Errors Reported)", multiple_errors_code);
+
+    std::string overflow_code=R"(x=2147483647;print(inc(x));)";
+    run_test("INVALID Program (Integer Overflow)", overflow_code);
+
+    run_backend_check("BACKENDS (Runtime Error)",R"(w=2147483646;print(inc(w));print(inc(inc(w)));print(w);)",R"(w=2147483646;print(inc(w));print(inc(inc(w)));print(w);)");
+    run_backend_check("BACKENDS (All Errors Reported)",multiple_errors_code,multiple_errors_code);
+    std::string syntax_errors_code=R"(print(inc(inc(5);x=99999999999;print(inc(x));y=1;print(inc(inc(y));print(q);inc(3);print(inc y);print(inc(inc(2147483647)));)";
+    run_backend_check("BACKENDS (Syntax and Semantic Errors)",syntax_errors_code,syntax_errors_code);
+    std::string range_code=R"(x=99999999999;print(y);print(inc(99999999999));print(inc(z));x=1;print(x);)";
+    run_backend_check("BACKENDS (Out-of-Range Literals)",range_code,range_code);
+    report("Statements after an out-of-range literal",compile_errors(range_code)=="Syntax Error: Integer literal '99999999999' is out of range at line 1, column 3\nSyntax Error: Integer literal '99999999999' is out of range at line 1, column 34\nSemantic Error: Variable 'y' is undeclared at line 1, column 21\nSemantic Error: Variable 'z' is undeclared at line 1, column 58\n","diagnostics");
+    std::string array_code=R"(a=[4];a[3]=2147483646;print(inc(a));print(inc(a[3]));print(a);print(inc(inc(a)));)";
+    run_backend_check("BACKENDS (Arrays, Runtime Error)",array_code,array_code);
+    std::string chunked_code;
+    for(int i=0;i<70000;i++){chunked_code+="v"+std::to_string(i%64)+"="+std::to_string(i)+";print(inc(v"+std::to_string(i%64)+"));\n";}
+    chunked_code+="w=2147483647;print(inc(w));print(v1);\n";
+    run_backend_check("BACKENDS (140000 Statements, Runtime Error)",chunked_code,"v0=0;print(inc(v0)); ... v63=69999;print(inc(v63));\nw=2147483647;print(inc(w));print(v1);");
+
+    run_spsc_check();
+    run_pool_check();
+    run_repl_check();
+    run_document_check();
+    run_lsp_check();
+    run_literal_check();
+    run_parallel_check();
+    run_analysis_check();
+    run_repeat_check();
+    run_array_check();
+    run_columns_check();
     
-    return 0;
+    return mismatches?1:0;
 }
\ No newline at end of file